@@ -0,0 +1,150 @@
+#include <cmath>
+#include <vector>
+
+#include "aligned.hpp"
+#include "bench.hpp"
+#include "vec.hpp"
+
+
+namespace
+{
+    /*
+     * 1024 vectors of 16 bytes fit in L1, where a load split across two cache lines costs the most.
+     * Each case updates the same window again and again until it has processed count vectors.
+     */
+    const std::size_t WINDOW = 1024;
+    const float       SCALE  = 0.5f;
+
+    bool close(const float* a, const float* b)
+    {
+        for(uint32_t c=0;c<3;++c)
+        {
+            if (std::abs(a[c] - b[c]) > 1e-4f * (1.0f + std::abs(b[c])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename Vector>
+    void fill(Vector* vectors)
+    {
+        for(std::size_t i=0;i<WINDOW;++i)
+        {
+            const float x = static_cast<float>(i);
+            vectors[i] = Vector(x, 2.0f * x, 0.5f - x);
+        }
+    }
+
+#if defined(MTLKIT_SIMD_SSE2)
+    // Records of 4 floats from data, the last one of each being padding.
+    template<bool ALIGNED>
+    void update(float* data, std::size_t passes, const vec3& offset)
+    {
+        const __m128 scale = _mm_set1_ps(SCALE);
+        const __m128 add   = _mm_setr_ps(offset[0], offset[1], offset[2], 0.0f);
+        for(std::size_t pass=0;pass<passes;++pass)
+        {
+            for(std::size_t i=0;i<WINDOW;++i)
+            {
+                float* record = data + 4*i;
+                const __m128 value = ALIGNED ? _mm_load_ps(record) : _mm_loadu_ps(record);
+                const __m128 result = _mm_add_ps(_mm_mul_ps(value, scale), add);
+                if (ALIGNED)
+                {
+                    _mm_store_ps(record, result);
+                }
+                else
+                {
+                    _mm_storeu_ps(record, result);
+                }
+            }
+        }
+    }
+#endif
+}
+
+
+bool bench::aligned(std::size_t count)
+{
+    const std::size_t passes = (count + WINDOW - 1) / WINDOW;
+    const vec3 offset(1.0f, -2.0f, 0.25f);
+    std::vector<vec3> packed(WINDOW);
+    AlignedVector<avec3> padded(WINDOW);
+
+    std::printf("v = v*s + o on a window of %zu vec3 in L1 :\n", WINDOW);
+    fill(packed.data());
+    // 12 bytes per vector : 2 in 16 of them straddle two cache lines.
+    const double reference = bench::fastest([&]()
+    {
+        for(std::size_t pass=0;pass<passes;++pass)
+        {
+            for(vec3& v : packed)
+            {
+                v = v*SCALE + offset;
+            }
+        }
+    });
+    bench::report("vec3, 12 bytes, Vecf operators", reference, reference);
+    fill(padded.data());
+    const double operators = bench::fastest([&]()
+    {
+        for(std::size_t pass=0;pass<passes;++pass)
+        {
+            for(avec3& v : padded)
+            {
+                v = v*SCALE + offset;
+            }
+        }
+    });
+    bench::report("avec3, 16 bytes aligned, Vecf operators", operators, reference);
+    bool valid = true;
+    for(std::size_t i=0;i<WINDOW;++i)
+    {
+        valid = close(packed[i], padded[i]) && valid;
+    }
+
+#if defined(MTLKIT_SIMD_SSE2)
+    // One more record of room to shift the records by 4 bytes : 1 in 4 of them straddles two cache lines.
+    AlignedVector<float> records(4 * (WINDOW + 1));
+    struct Case
+    {
+        const char* name;
+        float*      data;
+        void        (*update)(float*, std::size_t, const vec3&);
+    };
+    const Case cases[] =
+    {
+        {"avec3 aligned, _mm_load_ps",          records.data(),     &update<true>},
+        {"avec3 aligned, _mm_loadu_ps",         records.data(),     &update<false>},
+        {"avec3 shifted 4 bytes, _mm_loadu_ps", records.data() + 1, &update<false>}
+    };
+    for(const Case& current : cases)
+    {
+        for(std::size_t i=0;i<WINDOW;++i)
+        {
+            const float x = static_cast<float>(i);
+            float* record = current.data + 4*i;
+            record[0] = x;
+            record[1] = 2.0f * x;
+            record[2] = 0.5f - x;
+            record[3] = 0.0f;
+        }
+        const double ms = bench::fastest([&]()
+        {
+            current.update(current.data, passes, offset);
+        });
+        bench::report(current.name, ms, reference);
+        for(std::size_t i=0;i<WINDOW;++i)
+        {
+            valid = close(current.data + 4*i, packed[i]) && valid;
+        }
+    }
+#endif
+    if (!valid)
+    {
+        std::printf("  mismatch\n");
+    }
+    return valid;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file bench.hpp
+ * @brief Declares the benchmarks of mtlkit-bench and the helpers they share.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_BENCH_HPP_INCLUDED
+#define MTLKIT_BENCH_HPP_INCLUDED
+
+#include <algorithm> // For std::min
+#include <chrono>    // For std::chrono::steady_clock
+#include <cstddef>   // For std::size_t
+#include <cstdio>    // For std::printf
+
+
+namespace bench
+{
+    const int RUNS = 5; //!< The runs of each case, the fastest one being reported.
+
+    /**
+     * @brief Runs \b work RUNS times.
+     * @param[in] work The code to measure.
+     * @return The fastest run, in milliseconds.
+     */
+    template<typename Work>
+    double fastest(Work work)
+    {
+        double best = 1e300;
+        for(int run=0;run<RUNS;++run)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            work();
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return best;
+    }
+
+    /**
+     * @brief Prints a line of results.
+     * @param[in] name      What was measured.
+     * @param[in] ms        Its time, in milliseconds.
+     * @param[in] reference The time to compare with, in milliseconds.
+     */
+    inline void report(const char* name, double ms, double reference)
+    {
+        std::printf("  %-40s %9.2f ms  x%.2f\n", name, ms, reference / ms);
+    }
+
+    /**
+     * @brief Measures a*s + b - c/t over \b count vec3 : Vecf one by one, eager VecStream kernels, fused VecStream.
+     * @param[in] count The number of vectors.
+     * @return false if the results differ.
+     */
+    bool vecstream(std::size_t count);
+
+    /**
+     * @brief Measures v*s + o over \b count vec3 : packed Vecf, AlignedVecf, then aligned and unaligned SSE2
+     * loads of AlignedVecf records on and off their alignment, the latter splitting cache lines.
+     * @param[in] count The number of vectors.
+     * @return false if the results differ.
+     */
+    bool aligned(std::size_t count);
+
+    /**
+     * @brief Measures the build of a BVH over \b count scattered triangles, with one thread then all of them.
+     * @param[in] count The number of triangles.
+     * @return false if the two trees differ.
+     */
+    bool bvh(std::size_t count);
+}
+
+#endif
@@ -0,0 +1,25 @@
+# The benchmarks backing the performance claims of the library, apart from the application.
+# Build it with : qmake bench/bench.pro && make, then run ./mtlkit-bench [elements].
+TEMPLATE = app
+TARGET = mtlkit-bench
+CONFIG += console release
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += \
+    ../include/
+
+SOURCES += \
+    ../src/BVH.cpp \
+    ../src/ThreadPool.cpp \
+    ../src/bounds.cpp \
+    aligned.cpp \
+    bvh.cpp \
+    main.cpp \
+    vecstream.cpp
+
+HEADERS += \
+    bench.hpp
+
+QMAKE_CXXFLAGS += -std=c++11 -Wall -Wextra
+QMAKE_CXXFLAGS_RELEASE += -O2 -march=native
+LIBS += -lpthread
@@ -0,0 +1,48 @@
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "BVH.hpp"
+#include "bench.hpp"
+
+
+bool bench::bvh(std::size_t count)
+{
+    // Small triangles scattered in a cube, visited through reversed indices.
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), offset(-0.5f, 0.5f);
+    std::vector<Vertex>   vertices(3 * count);
+    std::vector<uint32_t> indices(3 * count);
+    for(std::size_t t=0;t<count;++t)
+    {
+        const vec3 center(position(random), position(random), position(random));
+        for(std::size_t k=0;k<3;++k)
+        {
+            vertices[3*t + k] = center + vec3(offset(random), offset(random), offset(random));
+            indices[3*t + k]  = static_cast<uint32_t>(3*(count - 1 - t) + k);
+        }
+    }
+    ThreadPool single(0);
+    ThreadPool all(std::max(1u, std::thread::hardware_concurrency()) - 1);
+
+    std::printf("BVH of %zu triangles, %u threads :\n", count, all.workers() + 1);
+    std::vector<BVH::Node> serial, parallel;
+    const double one = bench::fastest([&]()
+    {
+        serial = BVH(vertices.data(), indices.data(), count, single).nodes();
+    });
+    const double many = bench::fastest([&]()
+    {
+        parallel = BVH(vertices.data(), indices.data(), count, all).nodes();
+    });
+    bench::report("binned SAH build, one thread", one, one);
+    bench::report("binned SAH build, every thread", many, one);
+
+    // The splits only depend on the sets of triangles, not on the threads that partitioned them.
+    if (serial.size() != parallel.size())
+    {
+        std::printf("  %zu nodes against %zu\n", parallel.size(), serial.size());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,16 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench.hpp"
+
+
+int main(int argc, char** argv)
+{
+    const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::printf("mtlkit-bench, %zu elements, fastest of %d runs\n", count, bench::RUNS);
+    bool valid = true;
+    valid = bench::vecstream(count) && valid;
+    valid = bench::aligned(count)   && valid;
+    valid = bench::bvh(count / 5)     && valid; // 2 million triangles by default.
+    return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
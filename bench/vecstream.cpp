@@ -0,0 +1,74 @@
+#include <cmath>
+#include <vector>
+
+#include "bench.hpp"
+#include "vecstream.hpp"
+
+
+namespace
+{
+    bool close(const vec3& a, const vec3& b)
+    {
+        for(uint32_t c=0;c<3;++c)
+        {
+            if (std::abs(a[c] - b[c]) > 1e-4f * (1.0f + std::abs(b[c])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+
+bool bench::vecstream(std::size_t count)
+{
+    const float s = 1.5f;
+    const float t = 4.0f;
+    std::vector<vec3> a(count), b(count), c(count), eager(count);
+    for(std::size_t i=0;i<count;++i)
+    {
+        const float x = static_cast<float>(i % 1024);
+        a[i] = vec3(x, x + 1.0f, x + 2.0f);
+        b[i] = vec3(2.0f, x, 0.5f * x);
+        c[i] = vec3(x * 0.25f, 3.0f, x);
+    }
+    Vec3Stream sa(a.data(), count), sb(b.data(), count), sc(c.data(), count);
+    Vec3Stream t1(count), t2(count), kernels(count), fused(count);
+
+    std::printf("a*s + b - c/t on vec3 :\n");
+    // Every operator of a Vecf chain makes a temporary vector.
+    const double vecf = bench::fastest([&]()
+    {
+        for(std::size_t i=0;i<count;++i)
+        {
+            eager[i] = a[i]*s + b[i] - c[i]/t;
+        }
+    });
+    // One pass over the whole streams per operation, with two intermediate streams.
+    const double passes = bench::fastest([&]()
+    {
+        scale(sa, s, t1);
+        add(t1, sb, t1);
+        scale(sc, -1.0f / t, t2);
+        add(t1, t2, kernels);
+    });
+    // A single pass, without any intermediate.
+    const double single = bench::fastest([&]()
+    {
+        fused = sa*s + sb - sc/t;
+    });
+    bench::report("Vecf, one vector at a time", vecf, vecf);
+    bench::report("VecStream, one kernel per operator", passes, vecf);
+    bench::report("VecStream, fused expression", single, vecf);
+
+    for(std::size_t i=0;i<count;++i)
+    {
+        if (!close(fused.get(i), eager[i]) || !close(kernels.get(i), eager[i]))
+        {
+            std::printf("  mismatch at %zu\n", i);
+            return false;
+        }
+    }
+    return true;
+}
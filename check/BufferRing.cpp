@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "BlockLayout.hpp"
+#include "BufferRing.hpp"
+#include "ProgramCache.hpp"
+#include "check.hpp"
+
+
+namespace
+{
+    const char* const VERTEX =
+        "#version 330 core\n"
+        "layout(location = 0) in vec3 position;\n"
+        "layout(std140) uniform PerObject\n"
+        "{\n"
+        "    mat4  model;\n"
+        "    mat3  normals;\n"
+        "    vec3  tint;\n"
+        "    float roughness;\n"
+        "    vec2  uv[3];\n"
+        "};\n"
+        "out vec4 color;\n"
+        "void main()\n"
+        "{\n"
+        "    color = vec4(normals * tint * roughness + vec3(uv[0] + uv[1] + uv[2], 0.0), 1.0);\n"
+        "    gl_Position = model * vec4(position, 1.0);\n"
+        "}\n";
+    const char* const FRAGMENT =
+        "#version 330 core\n"
+        "in vec4 color;\n"
+        "out vec4 fragment;\n"
+        "void main()\n"
+        "{\n"
+        "    fragment = color;\n"
+        "}\n";
+    const char* const MEMBERS[] = {"model", "normals", "tint", "roughness", "uv"};
+
+    typedef BlockLayout<Std140, mat4, mat3, vec3, float, std::array<vec2, 3>> PerObject;
+
+    template<typename T>
+    T read(const unsigned char* bytes, GLint offset)
+    {
+        T value;
+        std::memcpy(&value, bytes + offset, sizeof(T));
+        return value;
+    }
+}
+
+
+void check::bufferRing(void)
+{
+    ShaderProgram program;
+    ProgramCache::link(program, {{GL_VERTEX_SHADER, VERTEX}, {GL_FRAGMENT_SHADER, FRAGMENT}});
+    const GLuint id = static_cast<GLuint>(program);
+
+    GLuint indices[5];
+    GLint  offsets[5];
+    glGetUniformIndices(id, 5, MEMBERS, indices);
+    glGetActiveUniformsiv(id, 5, indices, GL_UNIFORM_OFFSET, offsets);
+    GLint arrayStrides[5];
+    GLint matrixStrides[5];
+    glGetActiveUniformsiv(id, 5, indices, GL_UNIFORM_ARRAY_STRIDE,  arrayStrides);
+    glGetActiveUniformsiv(id, 5, indices, GL_UNIFORM_MATRIX_STRIDE, matrixStrides);
+    GLint size = 0;
+    glGetActiveUniformBlockiv(id, glGetUniformBlockIndex(id, "PerObject"), GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    const GLint expected[5] = {PerObject::offset<0>(), PerObject::offset<1>(), PerObject::offset<2>(),
+                               PerObject::offset<3>(), PerObject::offset<4>()};
+    check::that(std::equal(offsets, offsets + 5, expected) && size == static_cast<GLint>(PerObject::SIZE),
+                "the std140 offsets and size match those of the driver");
+
+    check::that(program.bindUniformBlock("PerObject", 0), "a uniform block is bound");
+    check::that(!program.bindStorageBlock("PerObject", 0) && glGetError() == GL_NO_ERROR,
+                "a uniform block isn't a storage block, and asking raises no error");
+
+    BufferRing ring(GL_UNIFORM_BUFFER, 4096, 3);
+    bool written = true;
+    for(int frame=0;frame<5;++frame)
+    {
+        ring.beginFrame();
+        const float value = static_cast<float>(frame);
+        const std::array<vec2, 3> uv = {{vec2(value), vec2(value, 1.0f), vec2(1.0f, value)}};
+        const BufferRing::Range range = ring.write<PerObject>(mat4::identity(), mat3::identity(), vec3(value), value, uv);
+        ring.bind(0, range);
+        // Read back from the buffer at the offsets and strides the driver gives, not through range.data.
+        unsigned char bytes[PerObject::SIZE] = {};
+        glGetBufferSubData(GL_UNIFORM_BUFFER, range.offset, range.size, bytes);
+        const vec3 column = read<vec3>(bytes, offsets[1] + matrixStrides[1]);
+        const vec3 tint   = read<vec3>(bytes, offsets[2]);
+        written = written && column == vec3(0.0f, 1.0f, 0.0f) && tint == vec3(value) && read<float>(bytes, offsets[3]) == value;
+        for(std::size_t i=0;i<uv.size();++i)
+        {
+            written = written && read<vec2>(bytes, offsets[4] + static_cast<GLint>(i)*arrayStrides[4]) == uv[i];
+        }
+        ring.endFrame();
+    }
+    check::that(written && glGetError() == GL_NO_ERROR, ring.persistent() ? "each block is written in the mapped buffer, at the driver offsets"
+                                                                           : "each block is uploaded when bound, at the driver offsets");
+}
@@ -0,0 +1,116 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "ProgramCache.hpp"
+#include "check.hpp"
+
+
+namespace
+{
+    const char* const VERTEX =
+        "#version 330 core\n"
+        "layout(location = 0) in vec3 position;\n"
+        "uniform mat4 model;\n"
+        "void main()\n"
+        "{\n"
+        "#ifdef VARIANT\n"
+        "    gl_Position = model * vec4(-position, 1.0);\n"
+        "#else\n"
+        "    gl_Position = model * vec4(position, 1.0);\n"
+        "#endif\n"
+        "}\n";
+    const char* const FRAGMENT =
+        "#version 330 core\n"
+        "uniform vec4 color;\n"
+        "out vec4 fragment;\n"
+        "void main()\n"
+        "{\n"
+        "    fragment = color;\n"
+        "}\n";
+
+    std::string binaryPath(const std::string& directory, const std::vector<ProgramCache::Stage>& stages,
+                           const std::vector<std::string>& defines)
+    {
+        char name[24];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(ProgramCache::key(stages, defines)));
+        return directory + "/" + name;
+    }
+
+    std::vector<char> load(const std::string& file)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    void save(const std::string& file, const std::vector<char>& bytes)
+    {
+        std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+        stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    bool linked(const ShaderProgram& program)
+    {
+        GLint status = GL_FALSE;
+        glGetProgramiv(static_cast<GLuint>(program), GL_LINK_STATUS, &status);
+        return status == GL_TRUE && program.location(Uniform("color")) != -1;
+    }
+
+    bool stats(const ProgramCache& cache, std::size_t hits, std::size_t misses, std::size_t rejected)
+    {
+        const ProgramCache::Stats& current = cache.stats();
+        return current.hits == hits && current.misses == misses && current.rejected == rejected;
+    }
+}
+
+
+void check::programCache(const std::string& directory)
+{
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0)
+    {
+        std::printf("  skipped : the driver has no program binary format\n");
+        return;
+    }
+    const std::vector<ProgramCache::Stage> stages = {{GL_VERTEX_SHADER, VERTEX}, {GL_FRAGMENT_SHADER, FRAGMENT}};
+    const std::string file    = binaryPath(directory, stages, {});
+    const std::string variant = binaryPath(directory, stages, {"VARIANT"});
+    ProgramCache cache(directory);
+
+    ShaderProgram cold;
+    cache.build(cold, stages);
+    check::that(linked(cold) && stats(cache, 0, 1, 0), "a cold build misses and links from the sources");
+    const std::vector<char> bytes = load(file);
+    check::that(!bytes.empty(), "the binary is written once built");
+
+    ShaderProgram warm;
+    cache.build(warm, stages);
+    check::that(linked(warm) && stats(cache, 1, 1, 0), "a warm build hits and loads the binary");
+
+    save(file, std::vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 2));
+    ShaderProgram truncated;
+    cache.build(truncated, stages);
+    check::that(linked(truncated) && stats(cache, 1, 1, 1), "a truncated binary is rejected and the program rebuilt");
+    check::that(load(file) == bytes, "the rebuilt binary replaces the truncated one");
+
+    std::vector<char> corrupted = bytes;
+    corrupted[0] ^= 0xFF;
+    save(file, corrupted);
+    ShaderProgram magic;
+    cache.build(magic, stages);
+    check::that(linked(magic) && stats(cache, 1, 1, 2), "a binary with a bad magic is rejected and the program rebuilt");
+
+    ShaderProgram again;
+    cache.build(again, stages);
+    check::that(linked(again) && stats(cache, 2, 1, 2), "the rebuilt binary hits");
+
+    ShaderProgram other;
+    cache.build(other, stages, {"VARIANT"});
+    check::that(linked(other) && stats(cache, 2, 2, 2), "other defines miss");
+    check::that(variant != file && !load(variant).empty(), "other defines have a binary of their own");
+
+    std::remove(file.c_str());
+    std::remove(variant.c_str());
+}
@@ -0,0 +1,67 @@
+#include <vector>
+
+#include "ProgramCache.hpp"
+#include "ShaderProgram.hpp"
+#include "check.hpp"
+
+
+namespace
+{
+    const char* const VERTEX =
+        "#version 330 core\n"
+        "layout(location = 0) in vec3 position;\n"
+        "uniform mat4 model;\n"
+        "uniform vec3 offsets[4];\n"
+        "uniform int  index;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = model * vec4(position + offsets[index], 1.0);\n"
+        "}\n";
+    const char* const FRAGMENT =
+        "#version 330 core\n"
+        "uniform vec4 color;\n"
+        "out vec4 fragment;\n"
+        "void main()\n"
+        "{\n"
+        "    fragment = color;\n"
+        "}\n";
+
+    vec3 read(const ShaderProgram& program, const std::string& name)
+    {
+        vec3 value;
+        glGetUniformfv(static_cast<GLuint>(program), glGetUniformLocation(static_cast<GLuint>(program), name.c_str()), value);
+        return value;
+    }
+}
+
+
+void check::shaderProgram(void)
+{
+    ShaderProgram program;
+    ProgramCache::link(program, {{GL_VERTEX_SHADER, VERTEX}, {GL_FRAGMENT_SHADER, FRAGMENT}});
+    program.use();
+    static const Uniform OFFSETS("offsets");
+
+    check::that(program.isUniformValid("offsets[3]") && !program.isUniformValid("offsets[4]"),
+                "each element of an array is a uniform");
+    check::that(program.location(Uniform::find("offsets[0]")) == program.location(OFFSETS),
+                "an array and its first element share their location");
+
+    const vec3 offsets[4] = {vec3(1.0f, 2.0f, 3.0f), vec3(4.0f, 5.0f, 6.0f), vec3(7.0f, 8.0f, 9.0f), vec3(10.0f, 11.0f, 12.0f)};
+    program.setUniform(OFFSETS, offsets, 4);
+    check::that(read(program, "offsets[3]") == offsets[3] && glGetError() == GL_NO_ERROR, "an array is uploaded at once");
+
+    // Changed behind the program's back : a skipped upload leaves the zeros.
+    glUniform3f(glGetUniformLocation(static_cast<GLuint>(program), "offsets[3]"), 0.0f, 0.0f, 0.0f);
+    program.setUniform(OFFSETS, offsets, 4);
+    program.setUniform("offsets[3]", offsets[3]);
+    check::that(read(program, "offsets[3]") == vec3(0.0f), "the values already uploaded are skipped");
+
+    const vec3 tail[3] = {vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, 2.0f), vec3(0.0f, 0.0f, 3.0f)};
+    program.setUniform("offsets[2]", tail, 3);
+    check::that(read(program, "offsets[3]") == tail[1] && glGetError() == GL_NO_ERROR,
+                "an upload from an element stops at the end of the array");
+
+    check::that(!program.setUniform("colr", vec4(1.0f)) && Uniform::find("colr").id() == Uniform::NONE,
+                "a misspelled name is rejected without being interned");
+}
@@ -0,0 +1,66 @@
+/**
+ * @file check.hpp
+ * @brief Declares the checks of mtlkit-check and the helpers they share.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_CHECK_HPP_INCLUDED
+#define MTLKIT_CHECK_HPP_INCLUDED
+
+#include <cstddef> // For std::size_t
+#include <cstdio>  // For std::printf
+#include <string>  // For std::string
+
+
+namespace check
+{
+    /**
+     * @brief Grants access to the number of checks failed so far.
+     * @return A reference to this counter.
+     */
+    inline std::size_t& failures(void)
+    {
+        static std::size_t count = 0;
+        return count;
+    }
+
+    /**
+     * @brief Prints the result of a check and counts it if it failed.
+     * @param[in] passed If the check passed.
+     * @param[in] what   What was checked.
+     * @return \b passed.
+     */
+    inline bool that(bool passed, const std::string& what)
+    {
+        std::printf("  [%s] %s\n", passed ? " ok " : "FAIL", what.c_str());
+        if (!passed)
+        {
+            ++failures();
+        }
+        return passed;
+    }
+
+    /**
+     * @brief Checks ProgramCache : a cold miss, a warm hit, truncated and bad magic binaries rejected,
+     * and a miss for other defines, with the statistics after each build.
+     * @param[in] directory An empty directory for the binaries, emptied again at the end.
+     * @pre An OpenGL context must be current.
+     */
+    void programCache(const std::string& directory);
+
+    /**
+     * @brief Checks the uniforms of ShaderProgram : the elements of an array, the array uploads, the
+     * uploads skipped for unchanged values, and the names looked up without being interned.
+     * @pre An OpenGL context must be current.
+     */
+    void shaderProgram(void);
+
+    /**
+     * @brief Checks BlockLayout against the offsets the driver gives for the same std140 block, and that
+     * BufferRing writes and binds its blocks over several frames.
+     * @pre An OpenGL context must be current.
+     */
+    void bufferRing(void);
+}
+
+#endif
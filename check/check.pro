@@ -0,0 +1,25 @@
+# Checks the OpenGL side of the library against a real driver, without any window : the context comes
+# from EGL on a surfaceless display (Mesa llvmpipe on a headless machine).
+# Build it with : qmake check/check.pro && make, then run ./mtlkit-check, which returns 0 if all passed.
+TEMPLATE = app
+TARGET = mtlkit-check
+CONFIG += console
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += \
+    ../include/
+
+SOURCES += \
+    BufferRing.cpp \
+    main.cpp \
+    ProgramCache.cpp \
+    ShaderProgram.cpp \
+    ../src/BufferRing.cpp \
+    ../src/ProgramCache.cpp \
+    ../src/ShaderProgram.cpp
+
+HEADERS += \
+    check.hpp
+
+QMAKE_CXXFLAGS += -std=c++11 -Wall -Wextra
+LIBS += -lEGL -lGLEW -lGL -lpthread
@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <cstdlib>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <unistd.h>
+
+#include "GlCore.hpp"
+#include "check.hpp"
+
+
+namespace
+{
+    // An OpenGL 3.3 core context without any surface, so no window system is needed.
+    bool createContext(void)
+    {
+        const PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay == nullptr)
+        {
+            return false;
+        }
+        const EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display == EGL_NO_DISPLAY || eglInitialize(display, nullptr, nullptr) != EGL_TRUE || eglBindAPI(EGL_OPENGL_API) != EGL_TRUE)
+        {
+            return false;
+        }
+        const EGLint attributes[] =
+        {
+            EGL_CONTEXT_MAJOR_VERSION,       3,
+            EGL_CONTEXT_MINOR_VERSION,       3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        const EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+        return context != EGL_NO_CONTEXT && eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) == EGL_TRUE;
+    }
+
+    bool loadFunctions(void)
+    {
+#ifndef NO_GLEW
+        glewExperimental = GL_TRUE;
+        const GLenum status = glewInit();
+    #ifdef GLEW_ERROR_NO_GLX_DISPLAY
+        // A GLEW built for GLX loads the OpenGL functions, then fails to find an X display it doesn't need.
+        return status == GLEW_OK || status == GLEW_ERROR_NO_GLX_DISPLAY;
+    #else
+        return status == GLEW_OK;
+    #endif
+#else
+        return true;
+#endif
+    }
+}
+
+
+int main(void)
+{
+    if (!createContext() || !loadFunctions())
+    {
+        std::fprintf(stderr, "mtlkit-check : cannot create a surfaceless OpenGL 3.3 context with EGL\n");
+        return EXIT_FAILURE;
+    }
+    std::printf("mtlkit-check on %s\n", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    char directory[] = "/tmp/mtlkit-check-XXXXXX";
+    if (mkdtemp(directory) == nullptr)
+    {
+        std::fprintf(stderr, "mtlkit-check : cannot create a temporary directory\n");
+        return EXIT_FAILURE;
+    }
+    std::printf("ProgramCache :\n");
+    check::programCache(directory);
+    rmdir(directory);
+    std::printf("ShaderProgram :\n");
+    check::shaderProgram();
+    std::printf("BufferRing :\n");
+    check::bufferRing();
+
+    std::printf("%zu failed\n", check::failures());
+    return (check::failures() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file BVH.hpp
+ * @brief Defines a bounding volume hierarchy over triangles, for picking, shadow and visibility rays.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_BVH_HPP_INCLUDED
+#define MTLKIT_BVH_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bounds.hpp"
+#include "ThreadPool.hpp"
+#include "vec.hpp"
+
+
+/**
+ * @class Ray
+ * @brief A half line, origin + t * direction for t in [0, tMax].
+ */
+struct Ray final
+{
+    vec3  origin;    //!< Where the ray starts.
+    vec3  direction; //!< Its direction, which doesn't need to be normalized.
+    float tMax;      //!< The farthest parameter to consider.
+};
+
+/**
+ * @class RayHit
+ * @brief The closest intersection of a Ray, at origin + t * direction.
+ */
+struct RayHit final
+{
+    uint32_t triangle; //!< The index of the triangle hit, BVH::NONE if nothing was.
+    float    t;        //!< The ray parameter of the hit.
+    float    u;        //!< The barycentric weight of the second vertex.
+    float    v;        //!< The barycentric weight of the third vertex.
+};
+
+/**
+ * @class BVH
+ * @brief A binary tree of boxes over the triangles of a mesh, built with the binned surface area heuristic.
+ * @details The nodes are in a flat array of 32 bytes each, two siblings being always next to each other,
+ * and the triangles are copied in the order of the leaves, so a traversal reads the memory forward.
+ * The build splits the work across a ThreadPool : the top of the tree bins the triangles in parallel,
+ * then each remaining subtree is built by one thread.
+ *
+ * @code
+ * const BVH bvh(mesh.vertices.data(), mesh.indices.data(), mesh.indices.size() / 3);
+ * const RayHit hit = bvh.intersect(Ray{eye, direction, 1000.0f});
+ * if (hit.triangle != BVH::NONE)
+ * {
+ *     select(hit.triangle);
+ * }
+ * @endcode
+ */
+class BVH final
+{
+    public:
+        static const uint32_t NONE = UINT32_MAX; //!< The triangle of a RayHit when nothing is hit.
+
+        /**
+         * @class Node
+         * @brief A box, and either its two children (count == 0) or the triangles inside.
+         */
+        struct Node
+        {
+            AABB     bounds; //!< The box holding everything below.
+            uint32_t start;  //!< The left child (the right one is next) or the first triangle.
+            uint32_t count;  //!< The number of triangles of a leaf, 0 for an inner node.
+        };
+
+        /**
+         * @brief Builds the hierarchy of \b triangles triangles.
+         * @param[in] vertices  The positions.
+         * @param[in] indices   3 indices of \b vertices per triangle, or nullptr if the vertices
+         * are already 3 per triangle.
+         * @param[in] triangles The number of triangles.
+         * @param[in] pool      The threads to use.
+         */
+        BVH(const Vertex* vertices, const uint32_t* indices, std::size_t triangles, ThreadPool& pool = ThreadPool::shared());
+        /**
+         * @brief Finds the closest triangle along \b ray.
+         * @param[in] ray The ray.
+         * @return The closest hit, whose triangle is NONE if there is none.
+         */
+        RayHit intersect(const Ray& ray) const noexcept;
+        /**
+         * @brief Finds the closest triangle along each of \b count rays, split across \b pool.
+         * @param[in]  rays  The first ray.
+         * @param[out] hits  The first hit, one per ray.
+         * @param[in]  count The number of rays.
+         * @param[in]  pool  The threads to use.
+         */
+        void intersect(const Ray* rays, RayHit* hits, std::size_t count, ThreadPool& pool = ThreadPool::shared()) const;
+        /**
+         * @brief Tells if any triangle is along \b ray, faster than intersect() for shadows and visibility.
+         * @param[in] ray The ray.
+         * @return true at the first triangle found.
+         */
+        bool occluded(const Ray& ray) const noexcept;
+        /**
+         * @brief Lists the triangles whose box overlaps \b box.
+         * @param[in]  box       The box to query.
+         * @param[out] triangles The indices of these triangles are appended to it.
+         */
+        void query(const AABB& box, std::vector<uint32_t>& triangles) const;
+        /**
+         * @brief Lists the triangles whose box overlaps each of \b count boxes, split across \b pool.
+         * @param[in]  boxes     The first box to query.
+         * @param[in]  count     The number of boxes.
+         * @param[out] offsets   Replaced by count + 1 offsets : the triangles of the box i are from
+         * offsets[i] to offsets[i + 1] excluded.
+         * @param[out] triangles Replaced by the indices of these triangles, box after box.
+         * @param[in]  pool      The threads to use.
+         */
+        void query(const AABB* boxes, std::size_t count, std::vector<std::size_t>& offsets,
+                   std::vector<uint32_t>& triangles, ThreadPool& pool = ThreadPool::shared()) const;
+        /**
+         * @brief Grants access to the nodes, the root first.
+         * @return A reference to the node array, empty without triangles.
+         */
+        const std::vector<Node>& nodes(void) const noexcept;
+
+    private:
+        //! @brief A triangle, copied in the order of the leaves.
+        struct Triangle
+        {
+            vec3 a; //!< The first  vertex.
+            vec3 b; //!< The second vertex.
+            vec3 c; //!< The third  vertex.
+        };
+
+        std::vector<Node>     _nodes;     //!< The tree, siblings side by side.
+        std::vector<Triangle> _triangles; //!< The triangles, in the order of the leaves.
+        std::vector<uint32_t> _ids;       //!< The index given to the constructor of each of them.
+};
+
+static_assert(sizeof(BVH::Node) == 32, "BVH::Node must fill half a cache line");
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file BlockLayout.hpp
+ * @brief Computes at compile time where the members of a uniform or shader storage block are, in the
+ * std140 or std430 layout, and writes values there.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_BLOCKLAYOUT_HPP_INCLUDED
+#define MTLKIT_BLOCKLAYOUT_HPP_INCLUDED
+
+#include <array>   // For std::array
+#include <cstddef> // For std::size_t
+#include <cstdint> // For fixed bytes sized types.
+#include <cstring> // For std::memcpy
+
+#include "mat.hpp"
+#include "vec.hpp"
+
+
+/**
+ * @brief The layout of the uniform blocks declared with layout(std140).
+ * @details The arrays, including the columns of a matrix, have their elements on multiples of 16 bytes.
+ */
+struct Std140
+{
+    //! @brief The alignment of an array whose elements are aligned on \b align bytes.
+    static constexpr uint32_t array(uint32_t align) noexcept
+    {
+        return (align + 15) / 16 * 16;
+    }
+};
+
+/**
+ * @brief The layout of the shader storage blocks declared with layout(std430).
+ * @details The same as Std140, without rounding the arrays up to 16 bytes : a float[4] takes 16 bytes.
+ */
+struct Std430
+{
+    //! @brief The alignment of an array whose elements are aligned on \b align bytes.
+    static constexpr uint32_t array(uint32_t align) noexcept
+    {
+        return align;
+    }
+};
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _block // Do not try to use that.
+{
+    constexpr uint32_t roundUp(uint32_t value, uint32_t align) noexcept
+    {
+        return (value + align - 1) / align * align;
+    }
+
+    constexpr uint32_t greatest(uint32_t a, uint32_t b) noexcept
+    {
+        return (a > b) ? a : b;
+    }
+
+    /*
+     * ALIGN and SIZE of a member in the block, and write() copying it at its offset.
+     * The padding bytes are left untouched. The other types don't compile.
+     */
+    template<typename Standard, typename T> struct member;
+
+    template<typename Standard, typename T> struct scalar
+    {
+        static constexpr uint32_t ALIGN = 4;
+        static constexpr uint32_t SIZE  = 4;
+        static void write(unsigned char* destination, const T& value) noexcept
+        {
+            std::memcpy(destination, &value, sizeof(T));
+        }
+    };
+    template<typename Standard> struct member<Standard, float>    : public scalar<Standard, float>    {};
+    template<typename Standard> struct member<Standard, int32_t>  : public scalar<Standard, int32_t>  {};
+    template<typename Standard> struct member<Standard, uint32_t> : public scalar<Standard, uint32_t> {};
+
+    // A vec3 is aligned as a vec4, but a float may follow it in its last 4 bytes.
+    template<typename Standard, typename T, uint32_t N> struct member<Standard, Vecf<T, N>>
+    {
+        static_assert(sizeof(T) == 4 && N >= 2 && N <= 4, "Only the vectors of 2 to 4 floats or ints fit in a block");
+        static constexpr uint32_t ALIGN = (N == 2) ? 8 : 16;
+        static constexpr uint32_t SIZE  = N * 4;
+        static void write(unsigned char* destination, const Vecf<T, N>& value) noexcept
+        {
+            std::memcpy(destination, static_cast<const T*>(value), SIZE);
+        }
+    };
+
+    // An array of columns, or of rows for a RowMajor matrix (layout(row_major) in GLSL).
+    template<typename Standard, uint32_t Rows, uint32_t Cols, typename Layout>
+    struct member<Standard, Matrix<float, Rows, Cols, Layout>>
+    {
+        static constexpr uint32_t VECTORS = Layout::ROW_MAJOR ? Rows : Cols;
+        static constexpr uint32_t LENGTH  = Layout::ROW_MAJOR ? Cols : Rows;
+        static constexpr uint32_t ALIGN   = Standard::array(member<Standard, Vecf<float, LENGTH>>::ALIGN);
+        static constexpr uint32_t STRIDE  = roundUp(LENGTH * 4, ALIGN);
+        static constexpr uint32_t SIZE    = VECTORS * STRIDE;
+        static void write(unsigned char* destination, const Matrix<float, Rows, Cols, Layout>& value) noexcept
+        {
+            for(uint32_t v=0;v<VECTORS;++v)
+            {
+                std::memcpy(destination + v*STRIDE, value.data() + v*LENGTH, LENGTH * sizeof(float));
+            }
+        }
+    };
+
+    template<typename Standard, typename T, std::size_t N> struct member<Standard, std::array<T, N>>
+    {
+        static constexpr uint32_t ALIGN  = Standard::array(member<Standard, T>::ALIGN);
+        static constexpr uint32_t STRIDE = roundUp(member<Standard, T>::SIZE, ALIGN);
+        static constexpr uint32_t SIZE   = static_cast<uint32_t>(N) * STRIDE;
+        static void write(unsigned char* destination, const std::array<T, N>& value) noexcept
+        {
+            for(std::size_t i=0;i<N;++i)
+            {
+                member<Standard, T>::write(destination + i*STRIDE, value[i]);
+            }
+        }
+    };
+
+    // The members from the one starting at or after START.
+    template<typename Standard, uint32_t START, typename... Members> struct layout;
+
+    template<typename Standard, uint32_t START> struct layout<Standard, START>
+    {
+        static constexpr uint32_t END   = START;
+        static constexpr uint32_t ALIGN = 4;
+        static void write(unsigned char*) noexcept {}
+    };
+
+    template<typename Standard, uint32_t START, typename Member, typename... Others>
+    struct layout<Standard, START, Member, Others...>
+    {
+        typedef member<Standard, Member> current;
+        static constexpr uint32_t OFFSET = roundUp(START, current::ALIGN);
+
+        typedef layout<Standard, OFFSET + current::SIZE, Others...> next;
+        static constexpr uint32_t END   = next::END;
+        static constexpr uint32_t ALIGN = greatest(current::ALIGN, next::ALIGN);
+        static void write(unsigned char* destination, const Member& value, const Others&... others) noexcept
+        {
+            current::write(destination + OFFSET, value);
+            next::write(destination, others...);
+        }
+    };
+
+    template<uint32_t I, typename Layout> struct nth             : public nth<I - 1, typename Layout::next> {};
+    template<typename Layout>             struct nth<0, Layout> { static constexpr uint32_t OFFSET = Layout::OFFSET; };
+}
+//! @endcond
+
+
+/**
+ * @class BlockLayout
+ * @brief The layout of a block whose members are of the types \b Members, in their declaration order.
+ *
+ * Each member is float, int32_t, uint32_t, a Vecf of 2 to 4 of them, a Matrix of float (a RowMajor
+ * one matches a layout(row_major) member), or a std::array of any of these. The offsets, the size
+ * and the padding are those OpenGL computes for the same block declared with \b Standard, Std140
+ * for a uniform block or Std430 for a shader storage block.
+ *
+ * @code
+ * // layout(std140) uniform PerObject { mat4 model; mat3 normalMatrix; vec4 color; float roughness; };
+ * typedef BlockLayout<Std140, mat4, mat3, vec4, float> PerObject;
+ * static_assert(PerObject::offset<2>() == 112, "the columns of a mat3 take 16 bytes each");
+ * unsigned char block[PerObject::SIZE];
+ * PerObject::write(block, model, normalMatrix(model), color, 0.5f);
+ * @endcode
+ */
+template<typename Standard, typename... Members>
+struct BlockLayout
+{
+    private:
+        typedef _block::layout<Standard, 0, Members...> layout;
+
+    public:
+        static constexpr uint32_t ALIGN = Standard::array(layout::ALIGN);      //!< The alignment of the whole block.
+        static constexpr uint32_t SIZE  = _block::roundUp(layout::END, ALIGN); //!< Its size, padding included.
+
+        /**
+         * @brief Computes where the member \b I starts.
+         * @return Its offset in bytes from the start of the block.
+         */
+        template<uint32_t I>
+        static constexpr uint32_t offset(void) noexcept
+        {
+            static_assert(I < sizeof...(Members), "This block hasn't that many members");
+            return _block::nth<I, layout>::OFFSET;
+        }
+        /**
+         * @brief Writes every member at its offset in \b destination, leaving the padding as it is.
+         * @param[out] destination The start of the block, SIZE bytes, with no alignment required.
+         * @param[in]  values      The value of each member.
+         */
+        static void write(void* destination, const Members&... values) noexcept
+        {
+            layout::write(static_cast<unsigned char*>(destination), values...);
+        }
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file BufferRing.hpp
+ * @brief Defines a uniform or shader storage buffer handing out per-frame blocks, to feed many draws
+ * with one copy and one glBindBufferRange each instead of many glUniform* calls.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_BUFFERRING_HPP_INCLUDED
+#define MTLKIT_BUFFERRING_HPP_INCLUDED
+
+#include <cstddef> // For std::size_t
+#include <cstdint> // For fixed bytes sized types.
+#include <vector>  // For std::vector
+
+#include "GlCore.hpp"
+#include "BlockLayout.hpp"
+
+
+/**
+ * @class BufferRing
+ * @brief A buffer split into one section per frame in flight, each one allocated from its start again
+ * once the GPU is done with the frame which used it last.
+ *
+ * With ARB_buffer_storage (OpenGL 4.4), the buffer is mapped once for its whole life, coherently, and
+ * write() copies each block right where the shaders read it. Without it, the blocks are written aside
+ * and bind() uploads each one with glBufferSubData before binding it.
+ *
+ * Usage :
+ * @code
+ * // layout(std140) uniform PerObject { mat4 model; vec4 color; };
+ * typedef BlockLayout<Std140, mat4, vec4> PerObject;
+ * BufferRing ring(GL_UNIFORM_BUFFER, 1 << 20);
+ * program.bindUniformBlock("PerObject", 0);
+ * // Each frame :
+ * ring.beginFrame();
+ * for (const Object& object : objects)
+ * {
+ *     ring.bind(0, ring.write<PerObject>(object.model, object.color));
+ *     object.draw();
+ * }
+ * ring.endFrame();
+ * @endcode
+ */
+class BufferRing final
+{
+    public:
+        /**
+         * @class Range
+         * @brief A block allocated in the current frame.
+         */
+        struct Range
+        {
+            void*      data;   //!< Where to write the block.
+            GLintptr   offset; //!< Its offset in the buffer.
+            GLsizeiptr size;   //!< Its size in bytes.
+        };
+
+        /**
+         * @brief Creates a buffer of \b frames sections of \b frameSize bytes.
+         * @param[in] target    GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+         * @param[in] frameSize The bytes a frame may allocate, alignment included.
+         * @param[in] frames    The number of frames the GPU may lag behind, plus one.
+         * @throw std::invalid_argument If \b target isn't one of the two above, or \b frames is 0.
+         * @throw std::runtime_error    If OpenGL cannot create or map the buffer.
+         * @pre An OpenGL context must be current.
+         */
+        BufferRing(GLenum target, std::size_t frameSize, uint32_t frames = 3);
+        /**
+         * @brief Deletes the buffer.
+         */
+        ~BufferRing(void) noexcept;
+        /**
+         * @brief Moves to the section of the next frame, waiting for the GPU to be done with it.
+         */
+        void beginFrame(void);
+        /**
+         * @brief Marks the end of the commands using the current section, to know when it's free again.
+         */
+        void endFrame(void);
+        /**
+         * @brief Allocates \b size bytes in the current section, on the offset alignment of the target.
+         * @param[in] size The size of the block.
+         * @return The block, whose data is valid until the next beginFrame().
+         * @throw std::length_error If the current section has no room left.
+         */
+        Range allocate(std::size_t size);
+        /**
+         * @brief Allocates a block of the layout \b Layout (see BlockLayout) and writes \b values in it.
+         * @param[in] values The value of each member of the block.
+         * @return The block.
+         * @throw std::length_error If the current section has no room left.
+         */
+        template<typename Layout, typename... Values>
+        Range write(const Values&... values)
+        {
+            const Range range = this->allocate(Layout::SIZE);
+            Layout::write(range.data, values...);
+            return range;
+        }
+        /**
+         * @brief Binds \b range to the binding point \b binding of the target.
+         * @param[in] binding The binding point, given to ShaderProgram::bindUniformBlock() or bindStorageBlock().
+         * @param[in] range   A block of the current frame, fully written.
+         */
+        void bind(GLuint binding, const Range& range);
+        /**
+         * @brief Grants access to the number of bytes allocated in the current frame.
+         * @return The end of the last block, from the start of the section.
+         */
+        std::size_t used(void) const noexcept;
+        /**
+         * @brief Tells if the buffer is persistently mapped.
+         * @return false if bind() uploads each block.
+         */
+        bool persistent(void) const noexcept;
+        /**
+         * @brief Transform this BufferRing into its name from the OpenGL context.
+         */
+        operator GLuint(void) const noexcept;
+
+    private:
+        BufferRing(const BufferRing& other)            = delete;
+        BufferRing& operator=(const BufferRing& other) = delete;
+
+        GLenum                     _target;     //!< GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+        GLuint                     _id;         //!< The name of the buffer.
+        std::size_t                _alignment;  //!< The offset alignment of the target.
+        std::size_t                _frameSize;  //!< The size of a section, a multiple of the alignment.
+        uint32_t                   _frame;      //!< The current section.
+        std::size_t                _head;       //!< The bytes allocated in it.
+        unsigned char*             _memory;     //!< The mapped buffer, or _staging.
+        std::vector<unsigned char> _staging;    //!< The blocks waiting for bind() without persistent mapping.
+        std::vector<GLsync>        _fences;     //!< The end of the last frame of each section, or nullptr.
+        bool                       _persistent; //!< If _memory is the mapped buffer.
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file ProgramCache.hpp
+ * @brief Defines an on-disk cache of linked program binaries, to skip the shader compilation at startup.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_PROGRAMCACHE_HPP_INCLUDED
+#define MTLKIT_PROGRAMCACHE_HPP_INCLUDED
+
+#include <cstddef> // For std::size_t
+#include <cstdint> // For fixed bytes sized types.
+#include <string>  // For std::string
+#include <vector>  // For std::vector
+
+#include "GlCore.hpp"
+#include "ShaderProgram.hpp"
+
+
+/**
+ * @class ProgramCache
+ * @brief Stores the binary of each program it builds in a directory, and loads it back the next time.
+ *
+ * A binary is keyed by a hash of the sources, the defines and the vendor, renderer and version strings
+ * of the driver, so a driver update misses instead of loading a stale binary. When the driver refuses a
+ * binary anyway, or doesn't support ARB_get_program_binary at all, the program is built from its sources.
+ * Only a current OpenGL context is needed, so it works as well with a headless one (EGL, Mesa llvmpipe).
+ *
+ * Usage :
+ * @code
+ * ProgramCache cache("cache/shaders");
+ * ShaderProgram program;
+ * cache.build(program, {{GL_VERTEX_SHADER, vertexSource}, {GL_FRAGMENT_SHADER, fragmentSource}}, {"SHADOWS 1"});
+ * program.use();
+ * std::cout << cache.stats().hits << " hits" << std::endl;
+ * @endcode
+ */
+class ProgramCache final
+{
+    public:
+        /**
+         * @class Stage
+         * @brief The source of a shader of a program.
+         */
+        struct Stage
+        {
+            GLenum      type;   //!< GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, etc.
+            std::string source; //!< The GLSL code, starting with its #version line.
+        };
+
+        /**
+         * @class Stats
+         * @brief What the cache did since its construction.
+         */
+        struct Stats
+        {
+            std::size_t hits;     //!< The programs loaded from their binary.
+            std::size_t misses;   //!< The programs without a binary yet, built from their sources.
+            std::size_t rejected; //!< The binaries found but refused (corrupted, or by the driver), then rebuilt.
+        };
+
+        /**
+         * @brief Creates a cache in \b directory.
+         * @param[in] directory Where the binaries are, which must exist and be writable to store new ones.
+         */
+        explicit ProgramCache(const std::string& directory);
+        /**
+         * @brief Links \b program from its binary if there is a valid one, from \b stages otherwise.
+         * @details Each define is inserted as "#define <define>" after the #version line of every stage.
+         * A binary built here is written to the directory, ignoring any I/O error.
+         * @param[out] program The program to link, without any shader attached.
+         * @param[in]  stages  The shaders of the program.
+         * @param[in]  defines The macros to define, "NAME" or "NAME VALUE".
+         * @throw std::runtime_error If a shader doesn't compile or the program doesn't link, with the info log.
+         * @pre An OpenGL context must be current.
+         */
+        void build(ShaderProgram& program, const std::vector<Stage>& stages, const std::vector<std::string>& defines = {});
+        /**
+         * @brief Compiles \b stages and links \b program, without any cache.
+         * @param[out] program     The program to link, without any shader attached.
+         * @param[in]  stages      The shaders of the program.
+         * @param[in]  defines     The macros to define, see withDefines().
+         * @param[in]  retrievable If binary() will be called on the program.
+         * @throw std::runtime_error If a shader doesn't compile or the program doesn't link, with the info log.
+         * @pre An OpenGL context must be current.
+         */
+        static void link(ShaderProgram& program, const std::vector<Stage>& stages,
+                         const std::vector<std::string>& defines = {}, bool retrievable = false);
+        /**
+         * @brief Computes the key of a program, as build() does.
+         * @param[in] stages  The shaders of the program.
+         * @param[in] defines The macros to define.
+         * @return The hash of the driver strings, the stages and the defines.
+         * @pre An OpenGL context must be current.
+         */
+        static uint64_t key(const std::vector<Stage>& stages, const std::vector<std::string>& defines);
+        /**
+         * @brief Inserts "#define <define>" lines after the #version line of \b source, which must stay the first one.
+         * @param[in] source  The GLSL code.
+         * @param[in] defines The macros to define, "NAME" or "NAME VALUE".
+         * @return The code build() compiles.
+         */
+        static std::string withDefines(const std::string& source, const std::vector<std::string>& defines);
+        /**
+         * @brief Grants access to the statistics.
+         * @return The number of hits, misses and rejected binaries.
+         */
+        const Stats& stats(void) const noexcept;
+
+    private:
+        std::string _directory; //!< Where the binaries are.
+        Stats       _stats;     //!< The hits and misses.
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file ProgramQueue.hpp
+ * @brief Defines a queue compiling and linking programs without waiting for the driver.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_PROGRAMQUEUE_HPP_INCLUDED
+#define MTLKIT_PROGRAMQUEUE_HPP_INCLUDED
+
+#include <cstddef>    // For std::size_t
+#include <functional> // For std::function
+#include <future>     // For std::promise and std::shared_future
+#include <string>     // For std::string
+#include <vector>     // For std::vector
+
+#include "GlCore.hpp"
+#include "ProgramCache.hpp"
+#include "ShaderProgram.hpp"
+
+
+/**
+ * @class ProgramQueue
+ * @brief Submits the compilation and the link of many programs at once, and tells when each one is done.
+ *
+ * Shader::load() and ShaderProgram::link() query their status right away, which waits for the driver
+ * to finish each shader in turn. Here, every shader and program is submitted first, and poll() only asks
+ * GL_COMPLETION_STATUS_KHR, which never waits, so a driver with KHR_parallel_shader_compile (or the ARB
+ * one) compiles them on its own threads meanwhile. Without it, poll() finishes one program per call, so
+ * a loading screen still gets drawn between two of them.
+ *
+ * Everything must happen on the thread owning the OpenGL context : don't wait() on a future there before
+ * poll() or finish() has completed it.
+ *
+ * Usage :
+ * @code
+ * ProgramQueue queue;
+ * queue.submit(sky, {{GL_VERTEX_SHADER, skyVertex}, {GL_FRAGMENT_SHADER, skyFragment}});
+ * std::shared_future<void> terrainReady = queue.submit(terrain, terrainStages, {"SHADOWS 1"},
+ *     [](ShaderProgram& program, const std::string& error){ log(error.empty() ? "terrain ready" : error); });
+ * while (queue.pending() > 0)
+ * {
+ *     queue.poll();
+ *     drawLoadingScreen(queue.pending());
+ * }
+ * terrainReady.get(); // Throws the compilation or link error, if any.
+ * @endcode
+ */
+class ProgramQueue final
+{
+    public:
+        /**
+         * @brief Called by poll() when a program is done, with an empty \b error if it's linked.
+         */
+        typedef std::function<void(ShaderProgram& program, const std::string& error)> Ready;
+
+        /**
+         * @brief Creates an empty queue, looking for the parallel compilation extensions.
+         * @pre An OpenGL context must be current.
+         */
+        ProgramQueue(void);
+        /**
+         * @brief Deletes the shaders still pending, their futures get a std::future_error (broken promise).
+         */
+        ~ProgramQueue(void) noexcept;
+        /**
+         * @brief Starts the compilation of \b stages and the link of \b program, without waiting for them.
+         * @param[out] program The program to link, without any shader attached. It must outlive its completion.
+         * @param[in]  stages  The shaders of the program.
+         * @param[in]  defines The macros to define, see ProgramCache::withDefines().
+         * @param[in]  ready   Called by poll() once the program is done, may be empty.
+         * @return A future ready once the program is done, holding a std::runtime_error with the info log if
+         * a shader doesn't compile or the program doesn't link.
+         * @throw std::runtime_error If OpenGL cannot create a shader.
+         */
+        std::shared_future<void> submit(ShaderProgram& program, const std::vector<ProgramCache::Stage>& stages,
+                                        const std::vector<std::string>& defines = {}, Ready ready = Ready());
+        /**
+         * @brief Completes the programs the driver is done with, or a single one without the extensions.
+         * @return The number of programs completed by this call.
+         * @throw Anything thrown by a Ready callback.
+         */
+        std::size_t poll(void);
+        /**
+         * @brief Completes every pending program, waiting for the driver.
+         * @throw Anything thrown by a Ready callback.
+         */
+        void finish(void);
+        /**
+         * @brief Grants access to the number of programs not completed yet.
+         * @return The number of programs submitted and not completed by poll() or finish().
+         */
+        std::size_t pending(void) const noexcept;
+        /**
+         * @brief Tells if the driver compiles in parallel.
+         * @return true if KHR_parallel_shader_compile or ARB_parallel_shader_compile is supported.
+         */
+        bool parallel(void) const noexcept;
+
+    private:
+        //! @brief A program submitted and not completed yet.
+        struct Job
+        {
+            ShaderProgram*      program; //!< The program being linked.
+            std::vector<GLuint> shaders; //!< Its shaders, deleted once it's done.
+            std::promise<void>  promise; //!< What its future waits for.
+            Ready               ready;   //!< The callback.
+        };
+
+        ProgramQueue(const ProgramQueue& other)            = delete;
+        ProgramQueue& operator=(const ProgramQueue& other) = delete;
+
+        /**
+         * @brief Completes the jobs whose \b done flag is set, in submission order.
+         * @param[in] done One flag per job.
+         * @return The number of jobs completed.
+         */
+        std::size_t complete(const std::vector<bool>& done);
+
+        std::vector<Job> _jobs;     //!< The pending programs, in submission order.
+        bool             _parallel; //!< If GL_COMPLETION_STATUS_KHR can be queried.
+};
+
+#endif
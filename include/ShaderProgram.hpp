@@ -8,17 +8,166 @@
 #define MTLKIT_SHADERPROGRAM_HPP_INCLUDED
 
 #include "GlCore.hpp"
+#include <cstdint>          // For fixed bytes sized types.
+#include <cstring>          // For std::memcmp and std::memcpy
 #include <initializer_list> // For std::initializer_list
-#include <map>              // For std::map
 #include <string>           // For std::string
 #include <vector>           // For std::vector
 
+#include "mat.hpp"
+#include "vec.hpp"
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _uniform // Do not try to use that.
+{
+    /*
+     * How to upload a value of each type : SIZE bytes read from bytes(value) are compared with
+     * the last upload, upload() is the glUniform* call for one value or an array of them.
+     * The other types don't compile, and neither do the arrays of bool.
+     */
+    template<typename T> struct traits;
+
+    template<typename T, uint32_t N> struct vector;
+    template<> struct vector<float,    2> {static void upload(GLint l, GLsizei n, const float*    v) noexcept {glUniform2fv(l, n, v);}};
+    template<> struct vector<float,    3> {static void upload(GLint l, GLsizei n, const float*    v) noexcept {glUniform3fv(l, n, v);}};
+    template<> struct vector<float,    4> {static void upload(GLint l, GLsizei n, const float*    v) noexcept {glUniform4fv(l, n, v);}};
+    template<> struct vector<int32_t,  2> {static void upload(GLint l, GLsizei n, const int32_t*  v) noexcept {glUniform2iv(l, n, v);}};
+    template<> struct vector<int32_t,  3> {static void upload(GLint l, GLsizei n, const int32_t*  v) noexcept {glUniform3iv(l, n, v);}};
+    template<> struct vector<int32_t,  4> {static void upload(GLint l, GLsizei n, const int32_t*  v) noexcept {glUniform4iv(l, n, v);}};
+    template<> struct vector<uint32_t, 2> {static void upload(GLint l, GLsizei n, const uint32_t* v) noexcept {glUniform2uiv(l, n, v);}};
+    template<> struct vector<uint32_t, 3> {static void upload(GLint l, GLsizei n, const uint32_t* v) noexcept {glUniform3uiv(l, n, v);}};
+    template<> struct vector<uint32_t, 4> {static void upload(GLint l, GLsizei n, const uint32_t* v) noexcept {glUniform4uiv(l, n, v);}};
+
+    // GLSL names a matrix by its columns first : a mat2x3 has 2 columns of 3 rows.
+    template<uint32_t Cols, uint32_t Rows> struct matrix;
+    template<> struct matrix<2, 2> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix2fv(l, n, t, v);}};
+    template<> struct matrix<2, 3> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix2x3fv(l, n, t, v);}};
+    template<> struct matrix<2, 4> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix2x4fv(l, n, t, v);}};
+    template<> struct matrix<3, 2> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix3x2fv(l, n, t, v);}};
+    template<> struct matrix<3, 3> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix3fv(l, n, t, v);}};
+    template<> struct matrix<3, 4> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix3x4fv(l, n, t, v);}};
+    template<> struct matrix<4, 2> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix4x2fv(l, n, t, v);}};
+    template<> struct matrix<4, 3> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix4x3fv(l, n, t, v);}};
+    template<> struct matrix<4, 4> {static void upload(GLint l, GLsizei n, GLboolean t, const float* v) noexcept {glUniformMatrix4fv(l, n, t, v);}};
+
+    template<> struct traits<float>
+    {
+        static const std::size_t SIZE = sizeof(float);
+        static const void* bytes(const float& value) noexcept {return &value;}
+        static void upload(GLint l, const float& value) noexcept {glUniform1f(l, value);}
+        static void upload(GLint l, GLsizei n, const float* values) noexcept {glUniform1fv(l, n, values);}
+    };
+    template<> struct traits<int32_t>
+    {
+        static const std::size_t SIZE = sizeof(int32_t);
+        static const void* bytes(const int32_t& value) noexcept {return &value;}
+        static void upload(GLint l, const int32_t& value) noexcept {glUniform1i(l, value);}
+        static void upload(GLint l, GLsizei n, const int32_t* values) noexcept {glUniform1iv(l, n, values);}
+    };
+    template<> struct traits<uint32_t>
+    {
+        static const std::size_t SIZE = sizeof(uint32_t);
+        static const void* bytes(const uint32_t& value) noexcept {return &value;}
+        static void upload(GLint l, const uint32_t& value) noexcept {glUniform1ui(l, value);}
+        static void upload(GLint l, GLsizei n, const uint32_t* values) noexcept {glUniform1uiv(l, n, values);}
+    };
+    template<> struct traits<bool>
+    {
+        static const std::size_t SIZE = sizeof(bool);
+        static const void* bytes(const bool& value) noexcept {return &value;}
+        static void upload(GLint l, const bool& value) noexcept {glUniform1i(l, value ? 1 : 0);}
+    };
+    template<typename T, uint32_t N> struct traits<Vecf<T, N>>
+    {
+        static const std::size_t SIZE = N * sizeof(T);
+        static const void* bytes(const Vecf<T, N>& value) noexcept {return static_cast<const T*>(value);}
+        static void upload(GLint l, const Vecf<T, N>& value) noexcept {vector<T, N>::upload(l, 1, value);}
+        static void upload(GLint l, GLsizei n, const Vecf<T, N>* values) noexcept {vector<T, N>::upload(l, n, values[0]);}
+    };
+    template<uint32_t Rows, uint32_t Cols, typename Layout> struct traits<Matrix<float, Rows, Cols, Layout>>
+    {
+        static const std::size_t SIZE = Rows * Cols * sizeof(float);
+        static const void* bytes(const Matrix<float, Rows, Cols, Layout>& value) noexcept {return value.data();}
+        static void upload(GLint l, const Matrix<float, Rows, Cols, Layout>& value) noexcept
+        {
+            matrix<Cols, Rows>::upload(l, 1, Layout::ROW_MAJOR ? GL_TRUE : GL_FALSE, value.data());
+        }
+        static void upload(GLint l, GLsizei n, const Matrix<float, Rows, Cols, Layout>* values) noexcept
+        {
+            matrix<Cols, Rows>::upload(l, n, Layout::ROW_MAJOR ? GL_TRUE : GL_FALSE, values[0].data());
+        }
+    };
+}
+//! @endcond
+
+
+/**
+ * @class Uniform
+ * @brief An interned uniform name : the same name always gives the same small id, in any program.
+ *
+ * Creating one looks the name up in a global table, so they are meant to be created once, as a static
+ * or a member, and then used each frame by ShaderProgram::setUniform() without any string involved.
+ * An element of an array is a uniform of its own, "bones[3]", the array itself being its first element.
+ */
+class Uniform final
+{
+    public:
+        static const uint32_t NONE = UINT32_MAX; //!< The id of a name never interned, active in no program.
+
+        /**
+         * @brief Interns \b name.
+         * @param[in] name The name of the uniform in GLSL, "bones" or "bones[0]" for the start of an array.
+         */
+        explicit Uniform(const std::string& name);
+        /**
+         * @brief Looks \b name up without interning it, so a misspelled name doesn't stay in the table.
+         * @param[in] name The name of the uniform in GLSL.
+         * @return Its Uniform, whose id is NONE if the name was never interned.
+         */
+        static Uniform find(const std::string& name);
+        /**
+         * @brief Grants access to the id of the name.
+         * @return The same id for the same name, counting from 0 in order of first use.
+         */
+        uint32_t id(void) const noexcept
+        {
+            return this->_id;
+        }
+        /**
+         * @brief Grants access to the name.
+         * @return The name given to the constructor.
+         * @pre The id must not be NONE.
+         */
+        const std::string& name(void) const;
+
+    private:
+        //! @brief Wraps an id already in the table, or NONE.
+        explicit Uniform(uint32_t id) noexcept : _id(id)
+        {
+
+        }
+
+        uint32_t _id; //!< The index of the name in the global table.
+};
+
 
 /**
  * @class ShaderProgram
  * @brief A convenient way to create and manage a shader program for OpenGL.
  * 
- * Right now, it'll offer an uniform locations buffer to accelerate your code.
+ * Once linked, the active uniforms, each element of an array included, are listed with the last value
+ * uploaded to them, and setUniform() skips the upload of a value equal to that one.
+ *
+ * @code
+ * static const Uniform MODEL("model");
+ * static const Uniform BONES("bones");
+ * program.use();
+ * program.setUniform(MODEL, model);  // A mat4, uploaded.
+ * program.setUniform(MODEL, model);  // Unchanged, nothing to do.
+ * program.setUniform(BONES, pose.data(), pose.size()); // A single glUniformMatrix4fv for the whole array.
+ * program.setUniform("color", vec4(1.0f, 0.0f, 0.0f, 1.0f));
+ * @endcode
  */
 class ShaderProgram
 {
@@ -45,6 +194,28 @@ class ShaderProgram
          * @throw std::runtime_error If any error occurs.
          */
         void link(void);
+        /**
+         * @brief Retrieves the driver binary of this linked program, to skip the compilation in a later run.
+         * @details The program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set, and the
+         * driver must support ARB_get_program_binary.
+         * @param[out] format The driver format of this binary, to give back to loadBinary().
+         * @return The binary, empty if the driver couldn't give one.
+         */
+        std::vector<GLubyte> binary(GLenum& format) const;
+        /**
+         * @brief Loads a binary given by binary() instead of compiling and linking the shaders.
+         * @details A driver may refuse a binary from another version of itself, or for no reason at all :
+         * the program must then be built from its sources.
+         * @param[in] format The driver format of \b data.
+         * @param[in] data   The binary.
+         * @return true if the program is linked, false if the driver refused the binary.
+         */
+        bool loadBinary(GLenum format, const std::vector<GLubyte>& data) noexcept;
+        /**
+         * @brief Lists the active uniforms of this linked program, forgetting the values previously uploaded.
+         * @details Called by link() and loadBinary(), it has to be called after a link made without them.
+         */
+        void reflect(void);
         /**
          * @brief "Use" this program for the rendering.
          */
@@ -87,7 +258,6 @@ class ShaderProgram
         operator GLuint(void) noexcept;
         /**
          * @brief Checks if @b uniformName is a valid uniform within this shader program.
-         * @details If the requested uniform does exist, it will bufferize it location.
          * @param[in] uniformName The name of an uniform, which one you wanna check.
          * @return true if this uniform name is valid within this program, false otherwise.
          */
@@ -103,24 +273,164 @@ class ShaderProgram
          */
         std::vector<GLuint> getShaders(void) const noexcept;
         /**
-         * @brief 
-         * 1->4 int;
-         * 1->4 uint
-         * vecF
-         * Matrix
-         * count + float/int/uint*
-         * matrix 2->4, OxP avec O,P[2, 4] --> count, transpose, float*
+         * @brief Grants access to the location of \b uniform, without any OpenGL call.
+         * @param[in] uniform The uniform.
+         * @return Its location, -1 if it isn't an active uniform of this program.
+         */
+        GLint location(Uniform uniform) const noexcept;
+        /**
+         * @brief Makes the uniform block named \b blockName read the buffer bound to \b binding.
+         * @param[in] blockName The name of the block in GLSL.
+         * @param[in] binding   A binding point of GL_UNIFORM_BUFFER, see BufferRing::bind().
+         * @return false if this program has no such active block.
+         */
+        bool bindUniformBlock(const std::string& blockName, GLuint binding) noexcept;
+        /**
+         * @brief Makes the shader storage block named \b blockName use the buffer bound to \b binding.
+         * @param[in] blockName The name of the block in GLSL.
+         * @param[in] binding   A binding point of GL_SHADER_STORAGE_BUFFER, see BufferRing::bind().
+         * @return false if this program has no such active block, or if the context has neither OpenGL 4.3
+         * nor ARB_program_interface_query and ARB_shader_storage_buffer_object.
+         */
+        bool bindStorageBlock(const std::string& blockName, GLuint binding) noexcept;
+        /**
+         * @brief Uploads \b value to \b uniform, unless it's the value uploaded last time.
+         * @details \b T is float, int32_t, uint32_t, bool, a Vecf of float, int32_t or uint32_t
+         * (2 to 4 values), or a Matrix of float (2 to 4 rows and columns, any layout).
+         * The samplers are set with an int32_t.
+         * @param[in] uniform The uniform.
+         * @param[in] value   Its new value, of the type of the uniform in GLSL.
+         * @return false if \b uniform isn't an active uniform of this program.
+         * @pre This program must be in use.
+         */
+        template<typename T>
+        bool setUniform(Uniform uniform, const T& value) noexcept
+        {
+            typedef _uniform::traits<T> Traits;
+            static_assert(Traits::SIZE <= VALUE_SIZE, "This uniform type is too big to be cached");
+            UniformSlot* slot = this->slot(uniform);
+            if (slot == nullptr)
+            {
+                return false;
+            }
+            const void* bytes = Traits::bytes(value);
+            if (slot->uploaded && std::memcmp(slot->value, bytes, Traits::SIZE) == 0)
+            {
+                return true;
+            }
+            std::memcpy(slot->value, bytes, Traits::SIZE);
+            slot->uploaded = true;
+            Traits::upload(slot->location, value);
+            return true;
+        }
+        /**
+         * @brief Uploads \b count values to the array \b uniform with a single call, unless each element
+         * already holds its value.
+         * @details \b T is any type of setUniform(Uniform, const T&) but bool.
+         * @param[in] uniform The array, or its element where to start.
+         * @param[in] values  The first new value.
+         * @param[in] count   The number of values, those past the end of the array being ignored.
+         * @return false if \b uniform isn't an active uniform of this program.
+         * @pre This program must be in use.
          */
-        /*template<typename... RegularGLType>
-        bool setUniform(const std::string& uniformName, const RegularGLType&... values);*/
+        template<typename T>
+        bool setUniform(Uniform uniform, const T* values, std::size_t count) noexcept
+        {
+            typedef _uniform::traits<T> Traits;
+            static_assert(Traits::SIZE <= VALUE_SIZE, "This uniform type is too big to be cached");
+            static_assert(sizeof(T) == Traits::SIZE, "The values of an array must be tightly packed");
+            UniformSlot* first = this->slot(uniform);
+            if (first == nullptr)
+            {
+                return false;
+            }
+            // The elements of an array have their slots side by side.
+            count = (count < first->remaining) ? count : first->remaining;
+            std::size_t i = 0;
+            while (i < count && first[i].uploaded && std::memcmp(first[i].value, Traits::bytes(values[i]), Traits::SIZE) == 0)
+            {
+                ++i;
+            }
+            if (i == count)
+            {
+                return true;
+            }
+            for(i=0;i<count;++i)
+            {
+                std::memcpy(first[i].value, Traits::bytes(values[i]), Traits::SIZE);
+                first[i].uploaded = true;
+            }
+            Traits::upload(first->location, static_cast<GLsizei>(count), values);
+            return true;
+        }
+        /**
+         * @brief Uploads \b value to the uniform named \b uniformName, unless it's the value uploaded last time.
+         * @details Slower than with a Uniform kept aside, as \b uniformName has to be looked up.
+         * @param[in] uniformName The name of the uniform, "bones[3]" for an element of an array.
+         * @param[in] value       Its new value, see setUniform(Uniform, const T&).
+         * @return false if it isn't an active uniform of this program.
+         * @pre This program must be in use.
+         */
+        template<typename T>
+        bool setUniform(const std::string& uniformName, const T& value)
+        {
+            return this->setUniform(Uniform::find(uniformName), value);
+        }
+        /**
+         * @brief Uploads \b count values to the array named \b uniformName, see setUniform(Uniform, const T*, std::size_t).
+         * @param[in] uniformName The name of the array, or of its element where to start.
+         * @param[in] values      The first new value.
+         * @param[in] count       The number of values.
+         * @return false if it isn't an active uniform of this program.
+         * @pre This program must be in use.
+         */
+        template<typename T>
+        bool setUniform(const std::string& uniformName, const T* values, std::size_t count)
+        {
+            return this->setUniform(Uniform::find(uniformName), values, count);
+        }
     
     protected:
-        GLuint                               _id;        //!< The name of this program inside OpenGL.
-        mutable std::map<std::string, GLint> _locations; //!< A storage for the uniforms locations.
+        static const std::size_t VALUE_SIZE = 16 * sizeof(float); //!< The biggest value cached, a mat4.
+
+        /**
+         * @struct UniformSlot
+         * @brief An active uniform, and the last value uploaded to it.
+         */
+        struct UniformSlot
+        {
+            GLint         location;          //!< Its location.
+            uint32_t      remaining;         //!< The elements from this one to the end of its array, 1 if it isn't one.
+            bool          uploaded;          //!< If \b value holds the last upload.
+            unsigned char value[VALUE_SIZE]; //!< The bytes of the last value uploaded.
+        };
+
+        GLuint                                 _id;       //!< The name of this program inside OpenGL.
+        std::vector<UniformSlot>               _uniforms; //!< The active uniforms, each array element after the previous.
+        std::vector<uint32_t>                  _slots;    //!< The index in _uniforms by Uniform::id(), Uniform::NONE if inactive.
+
+        /**
+         * @brief Finds the slot of \b uniform.
+         * @param[in] uniform The uniform.
+         * @return nullptr if it isn't an active uniform of this program.
+         */
+        const UniformSlot* slot(Uniform uniform) const noexcept
+        {
+            const uint32_t index = (uniform.id() < this->_slots.size()) ? this->_slots[uniform.id()] : Uniform::NONE;
+            return (index != Uniform::NONE) ? &this->_uniforms[index] : nullptr;
+        }
+        /**
+         * @brief Finds the slot of \b uniform, to update it.
+         * @param[in] uniform The uniform.
+         * @return nullptr if it isn't an active uniform of this program.
+         */
+        UniformSlot* slot(Uniform uniform) noexcept
+        {
+            return const_cast<UniformSlot*>(static_cast<const ShaderProgram*>(this)->slot(uniform));
+        }
         
         /**
          * @brief Finds the uniform named @b uniformName location within this program.
-         * @details If it was found, store the location into the internal buffer for further usage.
          * @param[in] uniformName The uniforma name you wanna find.
          * @return -1 if it wasn't found, a number greater than 0 otherwise.
          */
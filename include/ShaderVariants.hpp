@@ -0,0 +1,124 @@
+/**
+ * @file ShaderVariants.hpp
+ * @brief Defines the variants of a shader program, one per set of defines, compiled when first used.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_SHADERVARIANTS_HPP_INCLUDED
+#define MTLKIT_SHADERVARIANTS_HPP_INCLUDED
+
+#include <cstddef>       // For std::size_t
+#include <list>          // For std::list
+#include <memory>        // For std::unique_ptr
+#include <string>        // For std::string
+#include <unordered_map> // For std::unordered_map
+#include <vector>        // For std::vector
+
+#include "ProgramCache.hpp"
+#include "ShaderProgram.hpp"
+
+
+/**
+ * @class ShaderVariants
+ * @brief The programs built from the same sources with different defines, instead of a copy of the files
+ * per variant.
+ *
+ * A variant is compiled the first time get() asks for it, so only the ones a frame uses are paid for.
+ * The defines are a set : their order and duplicates don't matter, and identical variants share a single
+ * program. At most capacity() programs are kept alive, the least recently used one being deleted when
+ * another one is needed. With a ProgramCache, a variant compiled again after its eviction is loaded from
+ * its binary.
+ *
+ * Usage :
+ * @code
+ * ShaderVariants lit({{GL_VERTEX_SHADER, vertexSource}, {GL_FRAGMENT_SHADER, fragmentSource}}, 16, &cache);
+ * for (const Mesh& mesh : meshes)
+ * {
+ *     lit.get(mesh.skinned ? std::vector<std::string>{"SKINNED", "BONES 64"} : std::vector<std::string>{}).use();
+ *     mesh.draw();
+ * }
+ * @endcode
+ */
+class ShaderVariants final
+{
+    public:
+        /**
+         * @class Stats
+         * @brief What get() did since the construction.
+         */
+        struct Stats
+        {
+            std::size_t hits;         //!< The calls finding their variant alive.
+            std::size_t compilations; //!< The variants built, from their sources or a cached binary.
+            std::size_t evictions;    //!< The variants deleted to stay within the capacity.
+        };
+
+        /**
+         * @brief Creates the variants of \b stages, none compiled yet.
+         * @param[in] stages   The base sources, each one starting with its #version line.
+         * @param[in] capacity The greatest number of programs alive at once.
+         * @param[in] cache    Where to store and look for the binaries, or nullptr to always compile.
+         * It must outlive this object.
+         * @throw std::invalid_argument If \b capacity is 0.
+         */
+        ShaderVariants(const std::vector<ProgramCache::Stage>& stages, std::size_t capacity, ProgramCache* cache = nullptr);
+        /**
+         * @brief Grants access to the variant of \b defines, compiling it if it isn't alive.
+         * @param[in] defines The macros to define, "NAME" or "NAME VALUE", in any order.
+         * @return The linked program, valid until capacity() other variants are asked for.
+         * @throw std::runtime_error If the variant doesn't compile or link, with the info log.
+         * @pre An OpenGL context must be current.
+         */
+        ShaderProgram& get(const std::vector<std::string>& defines);
+        /**
+         * @brief Tells if the variant of \b defines is alive, without compiling it nor marking it as used.
+         * @param[in] defines The macros to define, in any order.
+         * @return true if get() would return it right away.
+         */
+        bool contains(const std::vector<std::string>& defines) const;
+        /**
+         * @brief Deletes every program.
+         */
+        void clear(void) noexcept;
+        /**
+         * @brief Grants access to the number of programs alive.
+         * @return At most capacity().
+         */
+        std::size_t size(void) const noexcept;
+        /**
+         * @brief Grants access to the greatest number of programs alive at once.
+         * @return The capacity given to the constructor.
+         */
+        std::size_t capacity(void) const noexcept;
+        /**
+         * @brief Grants access to the statistics.
+         * @return The number of hits, compilations and evictions.
+         */
+        const Stats& stats(void) const noexcept;
+
+    private:
+        //! @brief A program alive, and the sorted defines it was built with.
+        struct Variant
+        {
+            std::string                    key;     //!< The sorted defines, one per line.
+            std::unique_ptr<ShaderProgram> program; //!< The linked program.
+        };
+
+        typedef std::list<Variant> Variants;
+
+        /**
+         * @brief Sorts \b defines and removes the duplicates.
+         * @param[in,out] defines The macros to define.
+         * @return These defines, one per line, to identify the variant.
+         */
+        static std::string normalize(std::vector<std::string>& defines);
+
+        std::vector<ProgramCache::Stage>                    _stages;   //!< The base sources.
+        std::size_t                                         _capacity; //!< The greatest size of _variants.
+        ProgramCache*                                       _cache;    //!< The binaries, may be nullptr.
+        Variants                                            _variants; //!< The most recently used first.
+        std::unordered_map<std::string, Variants::iterator> _index;    //!< The variants by key.
+        Stats                                               _stats;    //!< The hits and compilations.
+};
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief Offers a fixed set of worker threads to split big loops (batched transforms, culling...).
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_THREADPOOL_HPP_INCLUDED
+#define MTLKIT_THREADPOOL_HPP_INCLUDED
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @class ThreadPool
+ * @brief Keeps worker threads alive between the loops, so splitting a loop only costs a few wake-ups.
+ */
+class ThreadPool final
+{
+    public:
+        typedef std::function<void(std::size_t, std::size_t)> Range; //!< Processes the elements [begin, end).
+
+        /**
+         * @brief Starts \b workers threads.
+         * @param[in] workers The number of threads, 0 means every loop runs on the calling thread.
+         */
+        explicit ThreadPool(uint32_t workers);
+        //! @brief Waits for the queued work, then joins every thread.
+        ~ThreadPool(void) noexcept;
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        /**
+         * @brief Grants access to the pool shared by the whole program.
+         * It owns one thread less than the hardware ones, the calling thread being the last one.
+         * @return A reference to this pool, started at the first call.
+         */
+        static ThreadPool& shared(void);
+        /**
+         * @brief Grants access to the number of worker threads.
+         * @return The number of threads, without the calling one.
+         */
+        uint32_t workers(void) const noexcept;
+        /**
+         * @brief Splits [0, count) into ranges of at least \b grain elements, and runs \b task over them
+         * with every worker and the calling thread. It returns when every range is processed.
+         * @param[in] count The number of elements.
+         * @param[in] grain The minimum number of elements of a range, below it the loop isn't split.
+         * @param[in] task  The function processing a range, called concurrently.
+         * @throw Anything thrown by \b task, the first exception is rethrown once every range is done.
+         *
+         * @code
+         * ThreadPool::shared().parallelFor(vertices.size(), 4096, [&](std::size_t begin, std::size_t end)
+         * {
+         *     transform(model, &vertices[begin], &vertices[begin], end - begin);
+         * });
+         * @endcode
+         */
+        void parallelFor(std::size_t count, std::size_t grain, const Range& task);
+
+    private:
+        std::vector<std::thread>          _threads; //!< The workers.
+        std::deque<std::function<void()>> _jobs;    //!< The jobs waiting for a worker.
+        std::mutex                        _mutex;   //!< Protects _jobs and _stop.
+        std::condition_variable           _wakeUp;  //!< Notified when a job is queued or the pool stops.
+        bool                              _stop;    //!< True once the pool is being destroyed.
+
+        //! @brief The loop of every worker, running jobs until the pool stops.
+        void work(void);
+};
+
+#endif
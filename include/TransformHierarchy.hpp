@@ -0,0 +1,123 @@
+/**
+ * @file TransformHierarchy.hpp
+ * @brief Propagates the local transforms of a scene graph into world transforms, once per frame.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_TRANSFORMHIERARCHY_HPP_INCLUDED
+#define MTLKIT_TRANSFORMHIERARCHY_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ThreadPool.hpp"
+#include "transform.hpp"
+
+
+/**
+ * @class TransformHierarchy
+ * @brief A flat scene graph : the nodes are stored level after level, each level in its own arrays.
+ * @details A parent always lives in the previous level, so update() walks the levels in order
+ * and splits each of them across the ThreadPool, the nodes of a level being independent.
+ * Only the nodes whose local transform changed, and their subtrees, are recomputed.
+ *
+ * @code
+ * TransformHierarchy scene;
+ * const TransformHierarchy::Node car   = scene.add(Transform3::translation(position));
+ * const TransformHierarchy::Node wheel = scene.add(Transform3::translation(axle), car);
+ * scene.setLocal(car, Transform3::translation(newPosition));
+ * scene.update();
+ * glUniformMatrix4fv(location, 1, GL_FALSE, scene.world(wheel).toMat4().data());
+ * @endcode
+ */
+class TransformHierarchy final
+{
+    public:
+        typedef uint32_t Node; //!< The handle of a node, given by add().
+
+        static const Node NONE = UINT32_MAX; //!< The parent of the roots.
+
+        //! @brief Construct an empty hierarchy.
+        TransformHierarchy(void) noexcept;
+        /**
+         * @brief Adds a node under \b parent, its world transform is computed by the next update().
+         * @param[in] local  The transform from the node to its parent space.
+         * @param[in] parent The parent node, NONE for a root.
+         * @return The handle of the new node.
+         * @throw std::out_of_range If \b parent isn't a node of this hierarchy.
+         */
+        Node add(const Transform3& local, Node parent = NONE);
+        /**
+         * @brief Changes the local transform of \b node, so its subtree is recomputed by the next update().
+         * @param[in] node  The node to move.
+         * @param[in] local The transform from the node to its parent space.
+         * @pre \b node must be a node of this hierarchy.
+         */
+        void setLocal(Node node, const Transform3& local) noexcept;
+        /**
+         * @brief Grants access to the local transform of \b node.
+         * @param[in] node The node.
+         * @return A reference to this transform.
+         * @pre \b node must be a node of this hierarchy.
+         */
+        const Transform3& local(Node node) const noexcept;
+        /**
+         * @brief Grants access to the world transform of \b node, as of the last update().
+         * @param[in] node The node.
+         * @return A reference to this transform.
+         * @pre \b node must be a node of this hierarchy.
+         */
+        const Transform3& world(Node node) const noexcept;
+        /**
+         * @brief Grants access to the parent of \b node.
+         * @param[in] node The node.
+         * @return The parent, NONE for a root.
+         * @pre \b node must be a node of this hierarchy.
+         */
+        Node parent(Node node) const noexcept;
+        /**
+         * @brief Grants access to the number of nodes.
+         * @return The number of nodes added so far.
+         */
+        std::size_t size(void) const noexcept;
+        /**
+         * @brief Grants access to the depth of the hierarchy.
+         * @return The number of levels, 1 when there are only roots.
+         */
+        uint32_t levels(void) const noexcept;
+        /**
+         * @brief Recomputes the world transforms of the changed nodes and their subtrees, level after level.
+         * @details A level is skipped when nothing changed in it nor above it, and split across \b pool
+         * when it's big enough.
+         * @param[in] pool The threads to use.
+         * @return The number of world transforms recomputed.
+         */
+        std::size_t update(ThreadPool& pool = ThreadPool::shared());
+
+    private:
+        /**
+         * @brief The nodes of a given depth, in structure of arrays.
+         * A node is dirty if it must be recomputed, then stays so until its children are.
+         */
+        struct Level
+        {
+            std::vector<uint32_t>   parents; //!< The slot of each parent in the previous level.
+            std::vector<Node>       nodes;   //!< The handle of each slot.
+            std::vector<Transform3> locals;  //!< The local transforms.
+            std::vector<Transform3> worlds;  //!< The world transforms.
+            std::vector<uint8_t>    dirty;   //!< A byte per node so the threads never share a word.
+            std::size_t             changed; //!< The number of dirty nodes.
+        };
+        //! @brief Where a node lives.
+        struct Slot
+        {
+            uint32_t level; //!< The depth of the node.
+            uint32_t index; //!< Its position in the arrays of this level.
+        };
+
+        std::vector<Level> _levels; //!< The nodes, roots first.
+        std::vector<Slot>  _slots;  //!< The position of each node, by handle.
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file aligned.hpp
+ * @brief Defines an allocator returning over-aligned memory, for containers of SIMD friendly data.
+ *
+ * Before C++17, std::allocator ignores alignas() bigger than alignof(std::max_align_t), so a
+ * std::vector<avec4> or the lanes of a VecStream need this one to be loaded with aligned instructions.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_ALIGNED_HPP_INCLUDED
+#define MTLKIT_ALIGNED_HPP_INCLUDED
+
+#include <cstddef> // For std::size_t
+#include <cstdint> // For std::uintptr_t
+#include <cstdlib> // For std::malloc
+#include <limits>  // For std::numeric_limits
+#include <new>     // For std::bad_alloc
+#include <vector>  // For std::vector
+
+#include "simd.hpp"
+
+
+/**
+ * @class AlignedAllocator
+ * @brief A standard allocator whose every allocation starts on a multiple of \b A bytes.
+ * @details The default alignment is the one of the widest SIMD register, or alignof(T) if bigger.
+ *
+ * @code
+ * std::vector<avec4, AlignedAllocator<avec4>> positions(count);
+ * AlignedVector<float> weights(count); // Same thing, shorter.
+ * @endcode
+ */
+template<typename T, std::size_t A = (alignof(T) > MTLKIT_SIMD_ALIGNMENT ? alignof(T) : MTLKIT_SIMD_ALIGNMENT)>
+class AlignedAllocator
+{
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef T&          reference;
+        typedef const T&    const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        static const std::size_t ALIGNMENT = A; //!< The bytes alignment of every allocation.
+
+        //! @brief Needed by containers allocating their nodes, the alignment is kept.
+        template<typename U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, A> other;
+        };
+
+        AlignedAllocator(void) noexcept = default;
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, A>&) noexcept {}
+
+        /**
+         * @brief Allocates room for \b count objects, aligned on \b A bytes, without constructing them.
+         * @param[in] count The number of objects.
+         * @return The first object.
+         * @throw std::bad_alloc If the allocation fails.
+         */
+        T* allocate(std::size_t count)
+        {
+            if(count > this->max_size())
+            {
+                throw std::bad_alloc();
+            }
+            // The pointer given by malloc is hidden just before the aligned block, for deallocate().
+            void* raw = std::malloc(count*sizeof(T) + A + sizeof(void*));
+            if(raw == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + A - 1) & ~(A - 1);
+            reinterpret_cast<void**>(aligned)[-1] = raw;
+            return reinterpret_cast<T*>(aligned);
+        }
+        /**
+         * @brief Releases a block returned by allocate().
+         * @param[in] p The first object of the block.
+         */
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            if(p != nullptr)
+            {
+                std::free(reinterpret_cast<void**>(p)[-1]);
+            }
+        }
+        /**
+         * @brief Grants access to the maximum number of objects a single allocation can hold.
+         * @return The maximum count for allocate().
+         */
+        std::size_t max_size(void) const noexcept
+        {
+            return (std::numeric_limits<std::size_t>::max() - A - sizeof(void*)) / sizeof(T);
+        }
+
+    private:
+        static_assert(A != 0 && (A & (A - 1)) == 0, "The alignment must be a power of two");
+        static_assert(A >= alignof(T), "The alignment can't be weaker than the natural one of T");
+        static_assert(A >= sizeof(void*), "The alignment must leave room for the allocation header");
+};
+
+template<typename T, typename U, std::size_t A>
+bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) noexcept
+{
+    return true;
+}
+template<typename T, typename U, std::size_t A>
+bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) noexcept
+{
+    return false;
+}
+
+/**
+ * @brief A std::vector whose data() is aligned for SIMD loads.
+ */
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+#endif
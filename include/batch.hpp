@@ -0,0 +1,47 @@
+/**
+ * @file batch.hpp
+ * @brief Transforms whole arrays of vectors by a matrix, with SIMD kernels and the ThreadPool.
+ *
+ * The kernels use AVX (two vec4 per register) or SSE2 when the translation unit is compiled for them,
+ * see simd.hpp. Arrays bigger than BATCH_PARALLEL_THRESHOLD are split across ThreadPool::shared().
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_BATCH_HPP_INCLUDED
+#define MTLKIT_BATCH_HPP_INCLUDED
+
+#include <cstddef> // For std::size_t
+
+#include "mat.hpp"
+#include "vec.hpp"
+
+
+//! Below this number of vectors, a batch stays on the calling thread (waking the workers would cost more).
+const std::size_t BATCH_PARALLEL_THRESHOLD = 1 << 16;
+
+/**
+ * @brief Computes \b out[i] = \b m * \b in[i] for \b count vectors.
+ * @param[in]  m     The matrix to apply.
+ * @param[in]  in    The first vector to transform.
+ * @param[out] out   The first transformed vector, which can be \b in.
+ * @param[in]  count The number of vectors.
+ * @pre \b in and \b out must address at least \b count vectors, and be either equal or disjoint.
+ *
+ * @code
+ * std::vector<vec4> positions = loadPositions();
+ * transform(model, positions.data(), positions.data(), positions.size());
+ * @endcode
+ */
+void transform(const mat4& m, const vec4* in, vec4* out, std::size_t count);
+/**
+ * @brief Computes \b out[i] = (\b m * vec4(\b in[i], 1)).xyz() for \b count points (Vertex).
+ * @details The projective row of \b m is ignored, so it's meant for affine matrices (model, view).
+ * @param[in]  m     The matrix to apply.
+ * @param[in]  in    The first point to transform.
+ * @param[out] out   The first transformed point, which can be \b in.
+ * @param[in]  count The number of points.
+ * @pre \b in and \b out must address at least \b count points, and be either equal or disjoint.
+ */
+void transform(const mat4& m, const vec3* in, vec3* out, std::size_t count);
+
+#endif
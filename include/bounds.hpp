@@ -0,0 +1,184 @@
+/**
+ * @file bounds.hpp
+ * @brief Defines bounding volumes and the view frustum, to reject on the CPU what the camera can't see.
+ *
+ * The batched test (cull) reads the boxes from a BoxBatch, in structure of arrays, and tests
+ * 8 of them per AVX instruction or 4 per SSE2 instruction, see simd.hpp.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_BOUNDS_HPP_INCLUDED
+#define MTLKIT_BOUNDS_HPP_INCLUDED
+
+#include <cstddef> // For std::size_t
+#include <cstdint> // For fixed bytes sized types.
+
+#include "aligned.hpp"
+#include "mat.hpp"
+#include "transform.hpp"
+#include "vec.hpp"
+
+
+/**
+ * @class AABB
+ * @brief An axis aligned bounding box, between the corners \b lower and \b upper.
+ */
+struct AABB final
+{
+    vec3 lower; //!< The smallest coordinates.
+    vec3 upper; //!< The biggest coordinates.
+
+    /**
+     * @brief Computes the smallest box holding \b count points.
+     * @param[in] points The first point.
+     * @param[in] count  The number of points, at least 1.
+     * @return The new box.
+     */
+    static AABB fromPoints(const vec3* points, std::size_t count) noexcept;
+    /**
+     * @brief Computes the middle of the box.
+     * @return (lower + upper) / 2.
+     */
+    vec3 center(void) const noexcept
+    {
+        return (this->lower + this->upper) * 0.5f;
+    }
+    /**
+     * @brief Computes the half size of the box along each axis.
+     * @return (upper - lower) / 2.
+     */
+    vec3 extents(void) const noexcept
+    {
+        return (this->upper - this->lower) * 0.5f;
+    }
+};
+
+/**
+ * @class Sphere
+ * @brief A bounding sphere, cheaper to test than an AABB and unchanged by rotations.
+ */
+struct Sphere final
+{
+    vec3  center; //!< The middle of the sphere.
+    float radius; //!< Its radius, positive.
+};
+
+/**
+ * @brief Computes the smallest box holding \b box once transformed by \b t (Arvo's method).
+ * @param[in] t   The transform, as a model matrix.
+ * @param[in] box The box, in the model space.
+ * @return The new box, in the space \b t leads to.
+ */
+AABB transform(const Transform3& t, const AABB& box) noexcept;
+/**
+ * @brief Computes the smallest box holding both \b a and \b b.
+ * @param[in] a The first  box.
+ * @param[in] b The second box.
+ * @return The new box.
+ */
+inline AABB merge(const AABB& a, const AABB& b) noexcept
+{
+    return AABB{min(a.lower, b.lower), max(a.upper, b.upper)};
+}
+
+/**
+ * @class BoxBatch
+ * @brief Many AABB stored as centers and extents, one aligned array per component, for cull().
+ */
+class BoxBatch final
+{
+    public:
+        /**
+         * @brief Adds \b box at the end of the batch.
+         * @param[in] box The box to add.
+         */
+        void push(const AABB& box);
+        /**
+         * @brief Removes every box, the memory is kept.
+         */
+        void clear(void) noexcept;
+        /**
+         * @brief Reserves room for \b count boxes.
+         * @param[in] count The number of boxes.
+         */
+        void reserve(std::size_t count);
+        /**
+         * @brief Grants access to the number of boxes.
+         * @return The number of boxes pushed since the last clear().
+         */
+        std::size_t size(void) const noexcept;
+        /**
+         * @brief Grants access to a component of every box.
+         * @param[in] i 0, 1, 2 for the x, y, z of the centers, 3, 4, 5 for the x, y, z of the extents.
+         * @return The first value of this component, aligned for SIMD loads.
+         */
+        const float* lane(uint32_t i) const noexcept;
+
+    private:
+        AlignedVector<float> _lanes[6]; //!< The centers then the extents.
+};
+
+/**
+ * @class CullingStats
+ * @brief The result of a batched frustum test, to measure what the CPU saves to the GPU.
+ */
+struct CullingStats final
+{
+    std::size_t tested; //!< The number of volumes tested.
+    std::size_t culled; //!< The number of volumes outside the frustum.
+};
+
+/**
+ * @class Frustum
+ * @brief The 6 planes bounding what a camera sees, their normals pointing inside.
+ */
+class Frustum final
+{
+    public:
+        /**
+         * @brief Extracts the planes of \b viewProjection (Gribb and Hartmann's method).
+         * @param[in] viewProjection The projection times the view, mapping the frustum into [-1, 1]^3.
+         * With a model matrix as well, the volumes are tested in the model space.
+         */
+        explicit Frustum(const mat4& viewProjection) noexcept;
+        /**
+         * @brief Grants access to a plane, as (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside.
+         * @param[in] i The plane : left, right, bottom, top, near and far.
+         * @return The normalized plane.
+         * @pre \b i must be lower than 6.
+         */
+        const vec4& plane(uint32_t i) const noexcept;
+        /**
+         * @brief Tests \b box against the frustum, conservatively (a box may be kept near a corner).
+         * @param[in] box The box to test.
+         * @return false if the box is entirely outside.
+         */
+        bool intersects(const AABB& box) const noexcept;
+        /**
+         * @brief Tests \b sphere against the frustum, conservatively.
+         * @param[in] sphere The sphere to test.
+         * @return false if the sphere is entirely outside.
+         */
+        bool intersects(const Sphere& sphere) const noexcept;
+
+    private:
+        vec4 _planes[6]; //!< Left, right, bottom, top, near and far.
+};
+
+/**
+ * @brief Tests every box of \b boxes against \b frustum, as Frustum::intersects but 4 to 8 boxes at once.
+ * Batches bigger than BATCH_PARALLEL_THRESHOLD (see batch.hpp) are split across ThreadPool::shared().
+ * @param[in]  frustum The frustum.
+ * @param[in]  boxes   The boxes to test.
+ * @param[out] visible Set to 1 for each box intersecting the frustum, 0 otherwise.
+ * @return The number of boxes tested and culled.
+ * @pre \b visible must address boxes.size() bytes.
+ *
+ * @code
+ * const CullingStats stats = cull(Frustum(projection * view), boxes, visible.data());
+ * drawn += stats.tested - stats.culled;
+ * @endcode
+ */
+CullingStats cull(const Frustum& frustum, const BoxBatch& boxes, uint8_t* visible);
+
+#endif
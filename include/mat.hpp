@@ -16,69 +16,529 @@
 #include <iterator>    // For std::ostream_iterator.
 #include <array>       // To replace static C array.
 #include <stdexcept>   // For std::runtime_error
+#include <cmath>       // For std::abs
+
+#include "meta.hpp"
+#include "simd.hpp"
+#include "vec.hpp"
+
+
+/**
+ * @brief Stores a Matrix column after column, the layout GLSL, std140 and std430 use by default.
+ */
+struct ColumnMajor
+{
+    static constexpr bool ROW_MAJOR = false; //!< The \b transpose argument of glUniformMatrix*fv.
+
+    //! @brief The position of the value at \b row, \b col in the storage of a RxC matrix.
+    static constexpr uint32_t index(uint32_t row, uint32_t col, uint32_t R, uint32_t) noexcept
+    {
+        return col*R + row;
+    }
+    //! @brief The row of the value stored at \b i in a RxC matrix.
+    static constexpr uint32_t row(uint32_t i, uint32_t R, uint32_t) noexcept
+    {
+        return i % R;
+    }
+    //! @brief The column of the value stored at \b i in a RxC matrix.
+    static constexpr uint32_t col(uint32_t i, uint32_t R, uint32_t) noexcept
+    {
+        return i / R;
+    }
+};
+
+/**
+ * @brief Stores a Matrix row after row, as a GLSL block declared with layout(row_major).
+ */
+struct RowMajor
+{
+    static constexpr bool ROW_MAJOR = true; //!< The \b transpose argument of glUniformMatrix*fv.
+
+    //! @brief The position of the value at \b row, \b col in the storage of a RxC matrix.
+    static constexpr uint32_t index(uint32_t row, uint32_t col, uint32_t, uint32_t C) noexcept
+    {
+        return row*C + col;
+    }
+    //! @brief The row of the value stored at \b i in a RxC matrix.
+    static constexpr uint32_t row(uint32_t i, uint32_t, uint32_t C) noexcept
+    {
+        return i / C;
+    }
+    //! @brief The column of the value stored at \b i in a RxC matrix.
+    static constexpr uint32_t col(uint32_t i, uint32_t, uint32_t C) noexcept
+    {
+        return i % C;
+    }
+};
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _mat_kernel // Do not try to use that.
+{
+    /*
+     * The product of a RxK and a KxC matrix, stored column after column.
+     * A whole column of the result stays in R accumulators while the columns of a are scaled
+     * and summed into it, so each value of a and b is loaded once per output column.
+     */
+    template<typename T, uint32_t R, uint32_t K, uint32_t C>
+    struct kernel
+    {
+        static void multiply(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t j=0;j<C;++j)
+            {
+                T column[R];
+                for(uint32_t i=0;i<R;++i)
+                {
+                    column[i] = a[i] * b[j*K];
+                }
+                for(uint32_t k=1;k<K;++k)
+                {
+                    const T factor = b[j*K + k];
+                    for(uint32_t i=0;i<R;++i)
+                    {
+                        column[i] += a[k*R + i] * factor;
+                    }
+                }
+                std::copy(column, column + R, out + j*R);
+            }
+        }
+    };
+    /*
+     * Writes the transposition of the RxC matrix a into the CxR out.
+     */
+    template<typename T, uint32_t R, uint32_t C>
+    struct transpose
+    {
+        static void apply(const T* a, T* out) noexcept
+        {
+            for(uint32_t c=0;c<C;++c)
+            {
+                for(uint32_t r=0;r<R;++r)
+                {
+                    out[r*C + c] = a[c*R + r];
+                }
+            }
+        }
+    };
+#if defined(MTLKIT_SIMD_SSE2)
+    /*
+     * mat4 * (4xC) : each column of the result is the sum of the columns of a scaled by a broadcast of b.
+     * It covers mat4 * mat4 (C = 4) and mat4 * vec4 (C = 1).
+     */
+    template<uint32_t C>
+    struct kernel<float, 4, 4, C>
+    {
+        static __m128 madd(__m128 a, __m128 b, __m128 c) noexcept
+        {
+#if defined(MTLKIT_SIMD_FMA)
+            return _mm_fmadd_ps(a, b, c);
+#else
+            return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+        }
+        static void multiply(const float* a, const float* b, float* out) noexcept
+        {
+            const __m128 a0 = _mm_loadu_ps(a);
+            const __m128 a1 = _mm_loadu_ps(a + 4);
+            const __m128 a2 = _mm_loadu_ps(a + 8);
+            const __m128 a3 = _mm_loadu_ps(a + 12);
+            for(uint32_t j=0;j<C;++j)
+            {
+                const float* column = b + 4*j;
+                __m128 r = _mm_mul_ps(a0, _mm_set1_ps(column[0]));
+                r = kernel<float, 4, 4, C>::madd(a1, _mm_set1_ps(column[1]), r);
+                r = kernel<float, 4, 4, C>::madd(a2, _mm_set1_ps(column[2]), r);
+                r = kernel<float, 4, 4, C>::madd(a3, _mm_set1_ps(column[3]), r);
+                _mm_storeu_ps(out + 4*j, r);
+            }
+        }
+    };
+    template<>
+    struct transpose<float, 4, 4>
+    {
+        static void apply(const float* a, float* out) noexcept
+        {
+            __m128 c0 = _mm_loadu_ps(a);
+            __m128 c1 = _mm_loadu_ps(a + 4);
+            __m128 c2 = _mm_loadu_ps(a + 8);
+            __m128 c3 = _mm_loadu_ps(a + 12);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(out, c0);
+            _mm_storeu_ps(out + 4, c1);
+            _mm_storeu_ps(out + 8, c2);
+            _mm_storeu_ps(out + 12, c3);
+        }
+    };
+#endif
+    /*
+     * Determinant and inverse of a NxN matrix, by a LU decomposition with partial pivoting.
+     * The closed forms below take over up to 4x4. Since det(M) = det(tM) and inverse(tM) = t(inverse(M)),
+     * every kernel can read the storage as rows as well as columns.
+     * Integer matrices are decomposed in double, and their determinant rounded back.
+     */
+    template<typename T, uint32_t N>
+    struct square
+    {
+        typedef typename std::conditional<std::is_floating_point<T>::value, T, double>::type F;
+
+        // Decomposes a into lu (L below the diagonal with implicit 1s, U above), returns the permutation sign or 0.
+        static int decompose(const T* a, F* lu, uint32_t* pivots) noexcept
+        {
+            int sign = 1;
+            std::copy(a, a + N*N, lu);
+            for(uint32_t k=0;k<N;++k)
+            {
+                uint32_t pivot = k;
+                for(uint32_t r=k+1;r<N;++r)
+                {
+                    if (std::abs(lu[r*N + k]) > std::abs(lu[pivot*N + k]))
+                    {
+                        pivot = r;
+                    }
+                }
+                pivots[k] = pivot;
+                if (lu[pivot*N + k] == F())
+                {
+                    return 0;
+                }
+                if (pivot != k)
+                {
+                    std::swap_ranges(lu + k*N, lu + (k+1)*N, lu + pivot*N);
+                    sign = -sign;
+                }
+                for(uint32_t r=k+1;r<N;++r)
+                {
+                    const F factor = (lu[r*N + k] /= lu[k*N + k]);
+                    for(uint32_t c=k+1;c<N;++c)
+                    {
+                        lu[r*N + c] -= factor * lu[k*N + c];
+                    }
+                }
+            }
+            return sign;
+        }
+        static T determinant(const T* a) noexcept
+        {
+            F lu[N*N];
+            uint32_t pivots[N];
+            F det = static_cast<F>(square<T, N>::decompose(a, lu, pivots));
+            for(uint32_t k=0;k<N;++k)
+            {
+                det *= lu[k*N + k];
+            }
+            return std::is_floating_point<T>::value ? static_cast<T>(det) : static_cast<T>(std::round(det));
+        }
+        // Solves lu * x = e_c for each column c, returns false for a singular matrix.
+        static bool inverse(const T* a, T* out) noexcept
+        {
+            F lu[N*N];
+            uint32_t pivots[N];
+            if (square<T, N>::decompose(a, lu, pivots) == 0)
+            {
+                return false;
+            }
+            for(uint32_t c=0;c<N;++c)
+            {
+                F x[N] = {};
+                x[c] = F(1);
+                for(uint32_t k=0;k<N;++k)
+                {
+                    std::swap(x[k], x[pivots[k]]);
+                }
+                for(uint32_t r=1;r<N;++r)
+                {
+                    for(uint32_t k=0;k<r;++k)
+                    {
+                        x[r] -= lu[r*N + k] * x[k];
+                    }
+                }
+                for(uint32_t r=N;r-->0;)
+                {
+                    for(uint32_t k=r+1;k<N;++k)
+                    {
+                        x[r] -= lu[r*N + k] * x[k];
+                    }
+                    x[r] /= lu[r*N + r];
+                }
+                for(uint32_t r=0;r<N;++r)
+                {
+                    out[r*N + c] = static_cast<T>(x[r]);
+                }
+            }
+            return true;
+        }
+    };
+    template<typename T>
+    struct square<T, 2>
+    {
+        static T determinant(const T* m) noexcept
+        {
+            return m[0]*m[3] - m[1]*m[2];
+        }
+        static bool inverse(const T* m, T* out) noexcept
+        {
+            const T det = square<T, 2>::determinant(m);
+            if (det == T())
+            {
+                return false;
+            }
+            const T a = m[0], b = m[1], c = m[2], d = m[3];
+            out[0] =  d / det;
+            out[1] = -b / det;
+            out[2] = -c / det;
+            out[3] =  a / det;
+            return true;
+        }
+    };
+    template<typename T>
+    struct square<T, 3>
+    {
+        static T determinant(const T* m) noexcept
+        {
+            return m[0]*(m[4]*m[8] - m[5]*m[7]) + m[1]*(m[5]*m[6] - m[3]*m[8]) + m[2]*(m[3]*m[7] - m[4]*m[6]);
+        }
+        // With the rows a, b, c, the columns of the inverse are b x c, c x a and a x b over det.
+        static bool inverse(const T* m, T* out) noexcept
+        {
+            const T bc[3] = {m[4]*m[8] - m[5]*m[7], m[5]*m[6] - m[3]*m[8], m[3]*m[7] - m[4]*m[6]};
+            const T ca[3] = {m[7]*m[2] - m[8]*m[1], m[8]*m[0] - m[6]*m[2], m[6]*m[1] - m[7]*m[0]};
+            const T ab[3] = {m[1]*m[5] - m[2]*m[4], m[2]*m[3] - m[0]*m[5], m[0]*m[4] - m[1]*m[3]};
+            const T det   = m[0]*bc[0] + m[1]*bc[1] + m[2]*bc[2];
+            if (det == T())
+            {
+                return false;
+            }
+            for(uint32_t r=0;r<3;++r)
+            {
+                out[r*3 + 0] = bc[r] / det;
+                out[r*3 + 1] = ca[r] / det;
+                out[r*3 + 2] = ab[r] / det;
+            }
+            return true;
+        }
+    };
+    /*
+     * The 4x4 cofactors from the 12 2x2 minors of the two upper and the two lower rows.
+     */
+    template<typename T>
+    struct cofactors4
+    {
+        static T determinant(const T* m) noexcept
+        {
+            const T s0 = m[0]*m[5] - m[4]*m[1], s1 = m[0]*m[6] - m[4]*m[2], s2 = m[0]*m[7] - m[4]*m[3];
+            const T s3 = m[1]*m[6] - m[5]*m[2], s4 = m[1]*m[7] - m[5]*m[3], s5 = m[2]*m[7] - m[6]*m[3];
+            const T c0 = m[8]*m[13] - m[12]*m[9],  c1 = m[8]*m[14] - m[12]*m[10], c2 = m[8]*m[15] - m[12]*m[11];
+            const T c3 = m[9]*m[14] - m[13]*m[10], c4 = m[9]*m[15] - m[13]*m[11], c5 = m[10]*m[15] - m[14]*m[11];
+            return s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+        }
+        static bool inverse(const T* m, T* out) noexcept
+        {
+            const T s0 = m[0]*m[5] - m[4]*m[1], s1 = m[0]*m[6] - m[4]*m[2], s2 = m[0]*m[7] - m[4]*m[3];
+            const T s3 = m[1]*m[6] - m[5]*m[2], s4 = m[1]*m[7] - m[5]*m[3], s5 = m[2]*m[7] - m[6]*m[3];
+            const T c0 = m[8]*m[13] - m[12]*m[9],  c1 = m[8]*m[14] - m[12]*m[10], c2 = m[8]*m[15] - m[12]*m[11];
+            const T c3 = m[9]*m[14] - m[13]*m[10], c4 = m[9]*m[15] - m[13]*m[11], c5 = m[10]*m[15] - m[14]*m[11];
+            const T det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+            if (det == T())
+            {
+                return false;
+            }
+            const T cofactors[16] = {
+                 m[5]*c5 - m[6]*c4 + m[7]*c3,  -m[1]*c5 + m[2]*c4 - m[3]*c3,
+                 m[13]*s5 - m[14]*s4 + m[15]*s3, -m[9]*s5 + m[10]*s4 - m[11]*s3,
+                -m[4]*c5 + m[6]*c2 - m[7]*c1,   m[0]*c5 - m[2]*c2 + m[3]*c1,
+                -m[12]*s5 + m[14]*s2 - m[15]*s1, m[8]*s5 - m[10]*s2 + m[11]*s1,
+                 m[4]*c4 - m[5]*c2 + m[7]*c0,  -m[0]*c4 + m[1]*c2 - m[3]*c0,
+                 m[12]*s4 - m[13]*s2 + m[15]*s0, -m[8]*s4 + m[9]*s2 - m[11]*s0,
+                -m[4]*c3 + m[5]*c1 - m[6]*c0,   m[0]*c3 - m[1]*c1 + m[2]*c0,
+                -m[12]*s3 + m[13]*s1 - m[14]*s0, m[8]*s3 - m[9]*s1 + m[10]*s0};
+            for(uint32_t i=0;i<16;++i)
+            {
+                out[i] = cofactors[i] / det;
+            }
+            return true;
+        }
+    };
+    template<typename T>
+    struct square<T, 4> : public cofactors4<T> {};
+#if defined(MTLKIT_SIMD_SSE2)
+    /*
+     * The 4x4 float inverse by 2x2 blocks : with M = |A B|, the adjugates of the blocks give every
+     *                                                |C D|
+     * cofactor in a few shuffles (E. Zhang, "Fast 4x4 Matrix Inverse with SSE SIMD, Explained").
+     * A 2x2 block is held as (m00, m01, m10, m11) in one register.
+     */
+    template<>
+    struct square<float, 4> : public cofactors4<float>
+    {
+        // a * b, a# * b and a * b#, with # the adjugate of a 2x2 block.
+        static __m128 mul(__m128 a, __m128 b) noexcept
+        {
+            return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+        static __m128 adjMul(__m128 a, __m128 b) noexcept
+        {
+            return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+        static __m128 mulAdj(__m128 a, __m128 b) noexcept
+        {
+            return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+        static bool inverse(const float* m, float* out) noexcept
+        {
+            const __m128 r0 = _mm_loadu_ps(m),     r1 = _mm_loadu_ps(m + 4);
+            const __m128 r2 = _mm_loadu_ps(m + 8), r3 = _mm_loadu_ps(m + 12);
+            const __m128 A = _mm_movelh_ps(r0, r1), B = _mm_movehl_ps(r1, r0);
+            const __m128 C = _mm_movelh_ps(r2, r3), D = _mm_movehl_ps(r3, r2);
+            // (|A|, |B|, |C|, |D|)
+            const __m128 dets = _mm_sub_ps(
+                _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+                _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+            const __m128 detA = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 detB = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 detC = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(2, 2, 2, 2));
+            const __m128 detD = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(3, 3, 3, 3));
+            const __m128 DC = square<float, 4>::adjMul(D, C);
+            const __m128 AB = square<float, 4>::adjMul(A, B);
+            // The adjugates of the blocks of the inverse, |M| inverse(M) = |X Y|
+            //                                                              |Z W|
+            __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), square<float, 4>::mul(B, DC));
+            __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), square<float, 4>::mul(C, AB));
+            __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), square<float, 4>::mulAdj(D, AB));
+            __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), square<float, 4>::mulAdj(A, DC));
+            // |M| = |A||D| + |B||C| - tr(A#B D#C)
+            __m128 trace = _mm_mul_ps(AB, _mm_shuffle_ps(DC, DC, _MM_SHUFFLE(3, 1, 2, 0)));
+            trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+            trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+            const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+            if (_mm_cvtss_f32(det) == 0.0f)
+            {
+                return false;
+            }
+            const __m128 scale = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+            X = _mm_mul_ps(X, scale);
+            Y = _mm_mul_ps(Y, scale);
+            Z = _mm_mul_ps(Z, scale);
+            W = _mm_mul_ps(W, scale);
+            // The adjugates back to the blocks, and the blocks back to rows.
+            _mm_storeu_ps(out,      _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3)));
+            _mm_storeu_ps(out + 4,  _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2)));
+            _mm_storeu_ps(out + 8,  _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3)));
+            _mm_storeu_ps(out + 12, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2)));
+            return true;
+        }
+    };
+#endif
+    /*
+     * The products for a layout. A row major matrix is stored as its column major transposition,
+     * and t(AB) = t(B)t(A), so the column major kernels run with the operands swapped.
+     */
+    template<typename Layout>
+    struct product
+    {
+        template<typename T, uint32_t R, uint32_t K, uint32_t C>
+        static void multiply(const T* a, const T* b, T* out) noexcept
+        {
+            kernel<T, R, K, C>::multiply(a, b, out);
+        }
+    };
+    template<>
+    struct product<RowMajor>
+    {
+        template<typename T, uint32_t R, uint32_t K, uint32_t C>
+        static void multiply(const T* a, const T* b, T* out) noexcept
+        {
+            kernel<T, C, K, R>::multiply(b, a, out);
+        }
+    };
+}
+//! @endcond
 
 
 /**
  * @class Matrix
  * @brief Defines a matrix <b>Rows</b>x<b>Cols</b> of type \b T.
+ * @details The values are stored contiguously as \b Layout tells, ColumnMajor by default as GLSL expects them,
+ * so data() can be given as is to glUniformMatrix*fv or copied into a uniform buffer :
+ * @code
+ * glUniformMatrix4fv(location, 1, mat4::layout::ROW_MAJOR, model.data());
+ * @endcode
+ * In std140 and std430 blocks, each column (each row for RowMajor) starts on a vec4 boundary :
+ * data() matches them when it holds 4 values (mat4, mat2x4, ...), a mat3 must be padded.
  */
-template<typename T, uint32_t Rows, uint32_t Cols>
+template<typename T, uint32_t Rows, uint32_t Cols, typename Layout = ColumnMajor>
 class Matrix final
 {
     public:
+        typedef Layout layout; //!< How the values are ordered in data().
+
         /**
          * @brief Construct a matrix, filled with the default value of \b T if
          * no argument was provide.
          * @param[in] value The default value for every matrix value.
          */
-        Matrix(const T& value = T()) noexcept
+        constexpr Matrix(const T& value = T()) noexcept
+            : Matrix(typename _meta::make_indices<Rows*Cols>::type(), value, value)
         {
-            this->_buffer.fill(value);
-        }
-        //! @brief Destroy the current matrix.
-        ~Matrix(void) noexcept
-        {
-            
+
         }
+        //! @brief The values are inline, so copies and moves are plain memberwise copies (Matrix is trivially copyable).
+        Matrix(const Matrix<T, Rows, Cols, Layout>& other) = default;
+        Matrix(Matrix<T, Rows, Cols, Layout>&& other) = default;
+        Matrix<T, Rows, Cols, Layout>& operator=(const Matrix<T, Rows, Cols, Layout>& other) = default;
+        Matrix<T, Rows, Cols, Layout>& operator=(Matrix<T, Rows, Cols, Layout>&& other) = default;
         /**
-         * @brief Construct a new matrix by copying \b other.
-         * @param[in] other The matrix to copy.
+         * @brief Construct a matrix with \b value on the diagonal, and T() elsewhere.
+         * @param[in] value The value of the diagonal.
+         * @return This new matrix, at compile time if \b value is a constant.
+         *
+         * @code
+         * constexpr mat4 scale = mat4::diagonal(2.0f);
+         * @endcode
          */
-        Matrix(const Matrix<T, Rows, Cols>& other) noexcept
+        static constexpr Matrix<T, Rows, Cols, Layout> diagonal(const T& value) noexcept
         {
-            this->copy(other);
+            return Matrix<T, Rows, Cols, Layout>(typename _meta::make_indices<Rows*Cols>::type(), value, T());
         }
         /**
-         * @brief Construct a new matrix by "moving" the buffered values.
-         * @param[in,out] other The other Matrix to move.
+         * @brief Construct the identity matrix, 1 on the diagonal and 0 elsewhere.
+         * @return This new matrix, at compile time.
          */
-        Matrix(Matrix<T, Rows, Cols>&& other) noexcept
+        static constexpr Matrix<T, Rows, Cols, Layout> identity(void) noexcept
         {
-            this->move(other);
+            return Matrix<T, Rows, Cols, Layout>::diagonal(T(1));
         }
         /**
-         * @brief Affects \b other to \b this by copy.
-         * @param[in] other The matrix to copy.
-         * @return A reference on this matrix.
+         * @brief Construct a matrix filled with 0.
+         * @return This new matrix, at compile time.
          */
-        Matrix<T, Rows, Cols>& operator=(const Matrix<T, Rows, Cols>& other) noexcept
+        static constexpr Matrix<T, Rows, Cols, Layout> zero(void) noexcept
         {
-            return this->copy(other);
+            return Matrix<T, Rows, Cols, Layout>(T());
         }
         /**
-         * @brief Affects \b other to \b this by move.
-         * @param[in] other The matrix to moves.
-         * @return A reference on this matrix.
+         * @brief Construct a matrix holding the values of \b other, stored in another layout.
+         * @param[in] other The matrix to reorder.
          */
-        Matrix<T, Rows, Cols>& operator=(Matrix<T, Rows, Cols>&& other) noexcept
+        template<typename L>
+        explicit Matrix(const Matrix<T, Rows, Cols, L>& other) noexcept
         {
-            return this->move(std::move(other));
+            for(uint32_t c=0;c<Cols;++c)
+            {
+                for(uint32_t r=0;r<Rows;++r)
+                {
+                    (*this)(r, c) = other(r, c);
+                }
+            }
         }
         /**
          * @brief Grants access to the number of columns of this Matrix.
          * @return The number of columns.
          */
-        inline uint32_t cols(void) const noexcept
+        constexpr uint32_t cols(void) const noexcept
         {
             return Cols;
         }
@@ -86,7 +546,7 @@ class Matrix final
          * @brief Grants access to the number of rows of this Matrix.
          * @return The number of rows.
          */
-        inline uint32_t rows(void) const noexcept
+        constexpr uint32_t rows(void) const noexcept
         {
             return Rows;
         }
@@ -94,7 +554,7 @@ class Matrix final
          * @brief Grants access to the number of elements stored on this matrix.
          * @return The number of elements, basicaly rows*cols.
          */
-        inline uint32_t nbElements(void) const noexcept
+        constexpr uint32_t nbElements(void) const noexcept
         {
             return Rows*Cols;
         }
@@ -102,35 +562,142 @@ class Matrix final
          * @brief Grants access to the size of the matrix.
          * @return The number elements stored on this matrix.
          */
-        uint32_t size(void) const noexcept
+        constexpr uint32_t size(void) const noexcept
         {
             return Rows;
         }
-        
-        Matrix<T, Cols, Rows> transpose(void) const noexcept
+        /**
+         * @brief Grants access to the values, in the order of \b Layout, without any copy.
+         * @return A pointer to the Rows*Cols contiguous values.
+         */
+        inline T* data(void) noexcept
         {
-            Matrix<T, Cols, Rows> result;
-            
-            // TODO
-            
+            return this->_buffer.data();
+        }
+        /**
+         * @brief Grants access to the values of a const matrix, in the order of \b Layout, without any copy.
+         * @return A pointer to the Rows*Cols contiguous values.
+         */
+        inline const T* data(void) const noexcept
+        {
+            return this->_buffer.data();
+        }
+        /**
+         * @brief Grants access to the value at \b row, \b col.
+         * @param[in] row The row index.
+         * @param[in] col The column index.
+         * @return A reference to this value.
+         * @pre \b row must be lower than Rows, \b col lower than Cols.
+         */
+        inline T& operator()(uint32_t row, uint32_t col) noexcept
+        {
+            return this->_buffer[Layout::index(row, col, Rows, Cols)];
+        }
+        /**
+         * @brief Grants access to the value at \b row, \b col, for a const matrix.
+         * @param[in] row The row index.
+         * @param[in] col The column index.
+         * @return A copy of this value.
+         * @pre \b row must be lower than Rows, \b col lower than Cols.
+         */
+        inline T operator()(uint32_t row, uint32_t col) const noexcept
+        {
+            return this->_buffer[Layout::index(row, col, Rows, Cols)];
+        }
+        /**
+         * @brief Computes the transposition of this matrix.
+         * @return A new matrix whose rows are the columns of this one.
+         */
+        Matrix<T, Cols, Rows, Layout> transpose(void) const noexcept
+        {
+            Matrix<T, Cols, Rows, Layout> result;
+            // A row major storage is the column major one of the transposition.
+            if (Layout::ROW_MAJOR)
+            {
+                _mat_kernel::transpose<T, Cols, Rows>::apply(this->_buffer.data(), result._buffer.data());
+            }
+            else
+            {
+                _mat_kernel::transpose<T, Rows, Cols>::apply(this->_buffer.data(), result._buffer.data());
+            }
             return result;
         }
         /**
          * @brief Computes the determinant of this matrix if possible.
+         * Up to 4x4 it's a closed form, a LU decomposition with partial pivoting above.
          * @return The result of this computation.
          * @pre The current matrix must be a square matrix.
          * @throw std::runtime_error If the matrix isn't square.
          */
-        double determinant(void) const
+        T determinant(void) const
         {
             return _determinant(std::integral_constant<bool, Rows == Cols>());
         }
+        /**
+         * @brief Computes the inverse of this matrix.
+         * Up to 4x4 it's a closed form (SSE for a float 4x4), a LU decomposition with partial pivoting above.
+         * @return A new matrix whose product with this one is the identity.
+         * @throw std::runtime_error If the matrix is singular.
+         */
+        Matrix<T, Rows, Cols, Layout> inverse(void) const
+        {
+            static_assert(Rows == Cols, "inverse isn't defined for a non square matrix");
+            static_assert(std::is_floating_point<T>::value, "inverse requires a floating point matrix");
+            Matrix<T, Rows, Cols, Layout> result;
+            if (!_mat_kernel::square<T, Rows>::inverse(this->_buffer.data(), result._buffer.data()))
+            {
+                throw std::runtime_error("inverse isn't defined for a singular matrix");
+            }
+            return result;
+        }
+        /**
+         * @brief Computes the inverse of an affine transform, faster than inverse().
+         * @details Only the linear part is inverted, the translation is then rotated back :
+         * inverse(|L t|) = |inverse(L) -inverse(L)t|
+         *         |0 1|    |    0            1     |
+         * @return A new matrix whose product with this one is the identity.
+         * @pre The last row must be (0, ..., 0, 1), as for model and view matrices.
+         * @throw std::runtime_error If the linear part is singular.
+         */
+        Matrix<T, Rows, Cols, Layout> affineInverse(void) const
+        {
+            static_assert(Rows == Cols && Rows >= 3, "affineInverse requires a square matrix of at least 3x3");
+            static_assert(std::is_floating_point<T>::value, "affineInverse requires a floating point matrix");
+            const uint32_t L = Rows - 1;
+            T linear[L*L], inverse[L*L];
+            for(uint32_t c=0;c<L;++c)
+            {
+                for(uint32_t r=0;r<L;++r)
+                {
+                    linear[c*L + r] = (*this)(r, c);
+                }
+            }
+            if (!_mat_kernel::square<T, L>::inverse(linear, inverse))
+            {
+                throw std::runtime_error("affineInverse isn't defined for a singular linear part");
+            }
+            Matrix<T, Rows, Cols, Layout> result;
+            for(uint32_t r=0;r<L;++r)
+            {
+                T translation = T();
+                for(uint32_t c=0;c<L;++c)
+                {
+                    result(r, c) = inverse[c*L + r];
+                    translation -= inverse[c*L + r] * (*this)(c, L);
+                }
+                result(r, L) = translation;
+            }
+            result(L, L) = T(1);
+            return result;
+        }
         
         
         
         
     private:
         std::array<T, Rows*Cols> _buffer; //!< The internal storage for the matrix' values [rows*cols].
+
+        template<typename TT, uint32_t R, uint32_t C, typename L> friend class Matrix;
         
         // Checks some aspects of the templates.
         static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type.");
@@ -138,43 +705,99 @@ class Matrix final
         static_assert(std::integral_constant<bool, Cols >= 2>::value, "You must precise at least 2 cols !");
         
         /**
-         * @brief Copies \b other elements.
-         * @param[in] other The matrix with the same dimensions to copy.
+         * @brief Construct a matrix with \b diagonal on the diagonal and \b other elsewhere.
+         * The element I is at row Layout::row(I) and column Layout::col(I).
          */
-        Matrix<T, Rows, Cols>& copy(const Matrix<T, Rows, Cols>& other) noexcept
+        template<uint32_t... I>
+        constexpr Matrix(_meta::indices<I...>, const T& diagonal, const T& other) noexcept
+            : _buffer{{((Layout::row(I, Rows, Cols) == Layout::col(I, Rows, Cols)) ? diagonal : other)...}}
         {
-            std::copy(other._buffer.cbegin(), other._buffer.cend(), this->_buffer.begin());
-            return *this;
-        }
-        /**
-         * @brief Moves \b other elements
-         * @param[in,out] other The matrix to moves, which will be filled with default values.
-         */
-        Matrix<T, Rows, Cols>& move(Matrix<T, Rows, Cols>&& other) noexcept
-        {
-            this->copy(other);
-            other.fill(T());
-            return *this;
+
         }
         /**
          * @brief Computes the square matrix determinant.
          * @return The result of this computation.
          */
-        double _determinant(std::true_type) const
+        T _determinant(std::true_type) const
         {
-            // TODO
-            return 0.0;
+            return _mat_kernel::square<T, Rows>::determinant(this->_buffer.data());
         }
         /**
          * @brief Undefined case of the determinant computation
          * @return Nothing
          * @throw std::runtime_error Because it's undefined.
          */
-        double _determinant(std::false_type) const
+        T _determinant(std::false_type) const
         {
             throw std::runtime_error("determinant isn't defined for a non square matrix");
         }
 };
 
+/**
+ * @brief Computes the product of \b m1 and \b m2.
+ * @param[in] m1 The left  matrix, RxK.
+ * @param[in] m2 The right matrix, KxC.
+ * @return A new RxC matrix, applying \b m2 then \b m1 to a vector.
+ */
+template<typename T, uint32_t R, uint32_t K, uint32_t C, typename L>
+Matrix<T, R, C, L> operator*(const Matrix<T, R, K, L>& m1, const Matrix<T, K, C, L>& m2) noexcept
+{
+    Matrix<T, R, C, L> result;
+    _mat_kernel::product<L>::template multiply<T, R, K, C>(m1.data(), m2.data(), result.data());
+    return result;
+}
+/**
+ * @brief Transforms \b v by \b m.
+ * @param[in] m The matrix, RxC.
+ * @param[in] v The vector, of C values.
+ * @return A new Vecf of R values.
+ */
+template<typename T, uint32_t R, uint32_t C, typename L>
+Vecf<T, R> operator*(const Matrix<T, R, C, L>& m, const Vecf<T, C>& v) noexcept
+{
+    Vecf<T, R> result;
+    _mat_kernel::product<L>::template multiply<T, R, C, 1>(m.data(), v, result);
+    return result;
+}
+
+/**
+ * @brief Computes the matrix transforming the normals of a model, the inverse transpose of its linear part.
+ * @details With c0, c1, c2 the columns of the linear part, its columns are c1 x c2, c2 x c0 and c0 x c1
+ * over the determinant, so it costs 3 cross products instead of an inverse and a transposition.
+ * @param[in] model The model matrix.
+ * @return The 3x3 normal matrix.
+ * @throw std::runtime_error If the linear part of \b model is singular.
+ */
+template<typename T, typename L>
+Matrix<T, 3, 3, L> normalMatrix(const Matrix<T, 4, 4, L>& model)
+{
+    static_assert(std::is_floating_point<T>::value, "normalMatrix requires a floating point matrix");
+    const Vecf<T, 3> c0(model(0, 0), model(1, 0), model(2, 0));
+    const Vecf<T, 3> c1(model(0, 1), model(1, 1), model(2, 1));
+    const Vecf<T, 3> c2(model(0, 2), model(1, 2), model(2, 2));
+    const Vecf<T, 3> columns[3] = {cross(c1, c2), cross(c2, c0), cross(c0, c1)};
+    const T det = dot(c0, columns[0]);
+    if (det == T())
+    {
+        throw std::runtime_error("normalMatrix isn't defined for a singular linear part");
+    }
+    Matrix<T, 3, 3, L> result;
+    for(uint32_t c=0;c<3;++c)
+    {
+        for(uint32_t r=0;r<3;++r)
+        {
+            result(r, c) = columns[c][r] / det;
+        }
+    }
+    return result;
+}
+
+typedef Matrix<float, 3, 3> mat3; //!< To manipulate a float 3x3 matrix (normal matrix).
+typedef Matrix<float, 4, 4> mat4; //!< To manipulate a float 4x4 matrix (model, view, projection).
+
+static_assert(std::is_trivially_copyable<mat4>::value, "mat4 must stay memcpy-able into instance buffers");
+static_assert(sizeof(mat4) == 16*sizeof(float), "mat4 must be tightly packed into instance buffers");
+static_assert(!mat4::layout::ROW_MAJOR, "mat4 must be column major, as GLSL expects it");
+
 
 #endif
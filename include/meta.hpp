@@ -0,0 +1,43 @@
+/**
+ * @file meta.hpp
+ * @brief Some compile time helpers shared by the math headers.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_META_HPP_INCLUDED
+#define MTLKIT_META_HPP_INCLUDED
+
+#include <cstdint> // For fixed bytes sized types.
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _meta // Do not try to use that.
+{
+    /*
+     * A pack of indices 0, 1, ..., N-1, to expand arrays inside constexpr initializer lists.
+     * Basically std::index_sequence, which doesn't exist in C++11.
+     * Both halves are built then joined, so the recursion depth is log2(N) (a 64x64 Matrix needs 4096).
+     */
+    template<uint32_t... I> struct indices {};
+    template<typename A, typename B> struct join;
+    template<uint32_t... I, uint32_t... J>
+    struct join<indices<I...>, indices<J...>>
+    {
+        typedef indices<I..., (sizeof...(I) + J)...> type;
+    };
+    template<uint32_t N>
+    struct make_indices : public join<typename make_indices<N/2>::type, typename make_indices<N - N/2>::type> {};
+    template<>
+    struct make_indices<0>
+    {
+        typedef indices<> type;
+    };
+    template<>
+    struct make_indices<1>
+    {
+        typedef indices<0> type;
+    };
+}
+//! @endcond
+
+#endif
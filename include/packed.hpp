@@ -0,0 +1,679 @@
+/**
+ * @file packed.hpp
+ * @brief Defines compact vertex formats (half floats, normalized integers, 10_10_10_2) and their
+ * conversions from/to Vecf<float, N>, one by one or by batch.
+ *
+ * Each format matches an OpenGL vertex attribute type :
+ *    - \b half2, \b half4                      : GL_HALF_FLOAT.
+ *    - \b snorm8x2, \b snorm8x4, \b unorm8x2... : GL_BYTE, GL_UNSIGNED_BYTE... with normalized = GL_TRUE.
+ *    - \b snorm1010102                         : GL_INT_2_10_10_10_REV with normalized = GL_TRUE.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_PACKED_HPP_INCLUDED
+#define MTLKIT_PACKED_HPP_INCLUDED
+
+#include <algorithm>   // For std::min, std::max
+#include <cmath>       // For std::nearbyint
+#include <cstddef>     // For std::size_t
+#include <cstdint>     // For fixed bytes sized types.
+#include <cstring>     // For std::memcpy
+#include <limits>      // For std::numeric_limits
+#include <type_traits> // For compile time checks.
+
+#include "simd.hpp"
+#include "vec.hpp"
+
+#if defined(MTLKIT_SIMD_SSE2) && defined(__F16C__)
+    #include <immintrin.h>
+    #define MTLKIT_SIMD_F16C 1
+#endif
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _packed // Do not try to use that.
+{
+    /*
+     * IEEE 754 binary32 -> binary16, rounded to nearest even, with denormals, infinities and NaN.
+     */
+    inline uint16_t floatToHalf(float value) noexcept
+    {
+        uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+        const uint32_t sign = (f >> 16) & 0x8000;
+        f &= 0x7FFFFFFF;
+        if (f >= 0x7F800000) // Infinity or NaN, which stays a quiet NaN.
+        {
+            return sign | 0x7C00 | ((f > 0x7F800000) ? (0x200 | ((f >> 13) & 0x3FF)) : 0);
+        }
+        if (f >= 0x477FF000) // Rounds above 65504, the biggest half.
+        {
+            return sign | 0x7C00;
+        }
+        if (f < 0x38800000) // Below 2^-14 : a half denormal.
+        {
+            if (f <= 0x33000000)
+            {
+                return sign;
+            }
+            const uint32_t mantissa = (f & 0x7FFFFF) | 0x800000;
+            const uint32_t shift    = 126 - (f >> 23);
+            const uint32_t rest     = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway  = 1u << (shift - 1);
+            uint32_t half = mantissa >> shift;
+            if (rest > halfway || (rest == halfway && (half & 1)))
+            {
+                ++half;
+            }
+            return sign | half;
+        }
+        uint32_t half = (f >> 13) - ((127 - 15) << 10);
+        const uint32_t rest = f & 0x1FFF;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        {
+            ++half;
+        }
+        return sign | half;
+    }
+    /*
+     * IEEE 754 binary16 -> binary32, which is exact.
+     */
+    inline float halfToFloat(uint16_t half) noexcept
+    {
+        const uint32_t sign     = static_cast<uint32_t>(half & 0x8000) << 16;
+        const uint32_t exponent = (half >> 10) & 0x1F;
+        const uint32_t mantissa = half & 0x3FF;
+        uint32_t f;
+        if (exponent == 0x1F)
+        {
+            // A NaN comes out quiet, as with F16C.
+            f = sign | 0x7F800000 | (mantissa << 13) | (mantissa ? 0x00400000 : 0);
+        }
+        else if (exponent == 0)
+        {
+            const float denormal = static_cast<float>(mantissa) * 5.9604644775390625e-8f; // 2^-24
+            return sign ? -denormal : denormal;
+        }
+        else
+        {
+            f = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+        float value;
+        std::memcpy(&value, &f, sizeof(value));
+        return value;
+    }
+
+    /*
+     * A format tells how one float is stored, and how to convert a whole array of them.
+     */
+    struct half
+    {
+        typedef uint16_t storage_type;
+        static storage_type pack(float f)          noexcept {return floatToHalf(f);}
+        static float        unpack(storage_type h) noexcept {return halfToFloat(h);}
+    };
+    /*
+     * Normalized integers, following the OpenGL rules : unorm maps [0, 1] to [0, MAX],
+     * snorm maps [-1, 1] to [-MAX, MAX], and -MAX-1 also reads as -1.
+     */
+    template<typename I>
+    struct norm
+    {
+        typedef I storage_type;
+        static constexpr float MAX = static_cast<float>(std::numeric_limits<I>::max());
+        static constexpr float INV = 1.0f / MAX; // The SIMD path multiplies too, so both give the same floats.
+        static constexpr float LOW = std::is_signed<I>::value ? -1.0f : 0.0f;
+        static storage_type pack(float f) noexcept
+        {
+            // LOW first : std::max returns it for NaN, as _mm_max_ps(f, LOW) does.
+            return static_cast<I>(std::nearbyint(std::min(std::max(LOW, f), 1.0f) * MAX));
+        }
+        static float unpack(storage_type v) noexcept
+        {
+            return std::max(static_cast<float>(v) * INV, LOW);
+        }
+    };
+    template<typename I> constexpr float norm<I>::MAX;
+    template<typename I> constexpr float norm<I>::INV;
+    template<typename I> constexpr float norm<I>::LOW;
+
+    /*
+     * Converts count contiguous floats, one at a time.
+     */
+    template<typename Format>
+    struct scalar_batch
+    {
+        typedef typename Format::storage_type storage_type;
+        static void pack(const float* in, storage_type* out, std::size_t count) noexcept
+        {
+            for(std::size_t i=0;i<count;++i)
+            {
+                out[i] = Format::pack(in[i]);
+            }
+        }
+        static void unpack(const storage_type* in, float* out, std::size_t count) noexcept
+        {
+            for(std::size_t i=0;i<count;++i)
+            {
+                out[i] = Format::unpack(in[i]);
+            }
+        }
+    };
+    /*
+     * The conversion used by the PackedVec functions, scalar by default.
+     */
+    template<typename Format>
+    struct batch : public scalar_batch<Format> {};
+#if defined(MTLKIT_SIMD_F16C)
+    template<>
+    struct batch<half>
+    {
+        static void pack(const float* in, uint16_t* out, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+            for(;i+4<=count;i+=4)
+            {
+                __m128i h = _mm_cvtps_ph(_mm_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), h);
+            }
+            for(;i<count;++i)
+            {
+                out[i] = half::pack(in[i]);
+            }
+        }
+        static void unpack(const uint16_t* in, float* out, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+            for(;i+4<=count;i+=4)
+            {
+                _mm_storeu_ps(out + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i))));
+            }
+            for(;i<count;++i)
+            {
+                out[i] = half::unpack(in[i]);
+            }
+        }
+    };
+#elif defined(MTLKIT_SIMD_SSE2)
+    /*
+     * Without F16C, the bits are converted with integer operations, 4 at a time, giving exactly the
+     * results of floatToHalf() and halfToFloat(), NaN payloads included.
+     */
+    inline __m128i floatToHalf(__m128 value) noexcept
+    {
+        const __m128i bits     = _mm_castps_si128(value);
+        const __m128i sign     = _mm_and_si128(bits, _mm_set1_epi32(0x80000000));
+        const __m128i absolute = _mm_xor_si128(bits, sign);
+        // Infinity and NaN, or the floats rounding above 65504.
+        const __m128i nan      = _mm_cmpgt_epi32(absolute, _mm_set1_epi32(0x7F800000));
+        const __m128i payload  = _mm_or_si128(_mm_set1_epi32(0x200), _mm_and_si128(_mm_srli_epi32(absolute, 13), _mm_set1_epi32(0x3FF)));
+        const __m128i special  = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(nan, payload));
+        const __m128i regular  = _mm_cmpgt_epi32(_mm_set1_epi32(0x477FF000), absolute);
+        // Below 2^-14, adding 0.5 lets the FPU round the mantissa to nearest even, at the place of a half denormal.
+        const __m128i magic    = _mm_set1_epi32(126 << 23);
+        const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(absolute), _mm_castsi128_ps(magic))), magic);
+        const __m128i small    = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), absolute);
+        // Otherwise, rebias the exponent and round on the 13 bits dropped, up on ties to an odd mantissa.
+        const __m128i odd      = _mm_and_si128(_mm_srli_epi32(absolute, 13), _mm_set1_epi32(1));
+        const __m128i rounded  = _mm_add_epi32(_mm_add_epi32(absolute, _mm_set1_epi32(0xFFF - ((127 - 15) << 23))), odd);
+        const __m128i normal   = _mm_srli_epi32(rounded, 13);
+        __m128i half = _mm_or_si128(_mm_and_si128(small, denormal), _mm_andnot_si128(small, normal));
+        half = _mm_or_si128(_mm_and_si128(regular, half), _mm_andnot_si128(regular, special));
+        return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+    }
+    inline __m128 halfToFloat(__m128i half) noexcept
+    {
+        // Scaling by 2^112 rebiases the exponent, and normalizes the denormals exactly.
+        const __m128i absolute = _mm_and_si128(half, _mm_set1_epi32(0x7FFF));
+        const __m128i sign     = _mm_slli_epi32(_mm_xor_si128(half, absolute), 16);
+        const __m128  scaled   = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(absolute, 13)), _mm_castsi128_ps(_mm_set1_epi32((127 + 112) << 23)));
+        const __m128i special  = _mm_and_si128(_mm_cmpgt_epi32(absolute, _mm_set1_epi32(0x7BFF)), _mm_set1_epi32(0x7F800000));
+        const __m128i quiet    = _mm_and_si128(_mm_cmpgt_epi32(absolute, _mm_set1_epi32(0x7C00)), _mm_set1_epi32(0x00400000));
+        return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(_mm_or_si128(sign, special), quiet)));
+    }
+    template<>
+    struct batch<half>
+    {
+        static void pack(const float* in, uint16_t* out, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+            for(;i+8<=count;i+=8)
+            {
+                // Sign extends the 16 low bits, so the saturating pack keeps them as they are.
+                __m128i a = _mm_srai_epi32(_mm_slli_epi32(floatToHalf(_mm_loadu_ps(in + i)),     16), 16);
+                __m128i b = _mm_srai_epi32(_mm_slli_epi32(floatToHalf(_mm_loadu_ps(in + i + 4)), 16), 16);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+            }
+            for(;i<count;++i)
+            {
+                out[i] = half::pack(in[i]);
+            }
+        }
+        static void unpack(const uint16_t* in, float* out, std::size_t count) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            std::size_t i = 0;
+            for(;i+8<=count;i+=8)
+            {
+                __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                _mm_storeu_ps(out + i,     halfToFloat(_mm_unpacklo_epi16(halves, zero)));
+                _mm_storeu_ps(out + i + 4, halfToFloat(_mm_unpackhi_epi16(halves, zero)));
+            }
+            for(;i<count;++i)
+            {
+                out[i] = half::unpack(in[i]);
+            }
+        }
+    };
+#endif
+#if defined(MTLKIT_SIMD_SSE2)
+    /*
+     * Clamps, scales and rounds (cvtps2dq rounds to nearest even, like std::nearbyint) 8 floats,
+     * then narrows them with Narrow::apply and stores 8 values. Unpacking widens 8 values with
+     * Narrow::widen into two vectors of 32 bits integers, then scales and clamps them.
+     */
+    template<typename Format, typename Narrow>
+    struct sse_norm_batch
+    {
+        typedef typename Format::storage_type storage_type;
+        static void pack(const float* in, storage_type* out, std::size_t count) noexcept
+        {
+            const __m128 low  = _mm_set1_ps(Format::LOW);
+            const __m128 high = _mm_set1_ps(1.0f);
+            const __m128 max  = _mm_set1_ps(Format::MAX);
+            std::size_t i = 0;
+            for(;i+8<=count;i+=8)
+            {
+                // maxps returns its second operand for NaN, so NaN packs to LOW like the scalar path.
+                __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i),     low), high);
+                __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), low), high);
+                Narrow::apply(_mm_cvtps_epi32(_mm_mul_ps(a, max)), _mm_cvtps_epi32(_mm_mul_ps(b, max)), out + i);
+            }
+            for(;i<count;++i)
+            {
+                out[i] = Format::pack(in[i]);
+            }
+        }
+        static void unpack(const storage_type* in, float* out, std::size_t count) noexcept
+        {
+            const __m128 low   = _mm_set1_ps(Format::LOW);
+            const __m128 scale = _mm_set1_ps(Format::INV);
+            std::size_t i = 0;
+            for(;i+8<=count;i+=8)
+            {
+                __m128i a, b;
+                Narrow::widen(in + i, a, b);
+                _mm_storeu_ps(out + i,     _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), scale), low));
+                _mm_storeu_ps(out + i + 4, _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(b), scale), low));
+            }
+            for(;i<count;++i)
+            {
+                out[i] = Format::unpack(in[i]);
+            }
+        }
+    };
+    /*
+     * Interleaving a value with itself then shifting it right arithmetically sign extends it,
+     * interleaving it with zeros extends it without sign.
+     */
+    struct narrow_snorm16
+    {
+        static void apply(__m128i a, __m128i b, int16_t* out) noexcept
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(a, b));
+        }
+        static void widen(const int16_t* in, __m128i& a, __m128i& b) noexcept
+        {
+            const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            a = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16);
+            b = _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16);
+        }
+    };
+    struct narrow_unorm16 // No packus_epi32 in SSE2 : shift into the signed range, pack, shift back.
+    {
+        static void apply(__m128i a, __m128i b, uint16_t* out) noexcept
+        {
+            const __m128i bias = _mm_set1_epi32(0x8000);
+            __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias), _mm_sub_epi32(b, bias));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_xor_si128(packed, _mm_set1_epi16(-0x8000)));
+        }
+        static void widen(const uint16_t* in, __m128i& a, __m128i& b) noexcept
+        {
+            const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            a = _mm_unpacklo_epi16(words, _mm_setzero_si128());
+            b = _mm_unpackhi_epi16(words, _mm_setzero_si128());
+        }
+    };
+    struct narrow_snorm8
+    {
+        static void apply(__m128i a, __m128i b, int8_t* out) noexcept
+        {
+            __m128i words = _mm_packs_epi32(a, b);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packs_epi16(words, words));
+        }
+        static void widen(const int8_t* in, __m128i& a, __m128i& b) noexcept
+        {
+            const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in));
+            const __m128i words = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+            a = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16);
+            b = _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16);
+        }
+    };
+    struct narrow_unorm8
+    {
+        static void apply(__m128i a, __m128i b, uint8_t* out) noexcept
+        {
+            __m128i words = _mm_packs_epi32(a, b);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(words, words));
+        }
+        static void widen(const uint8_t* in, __m128i& a, __m128i& b) noexcept
+        {
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128i words = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)), zero);
+            a = _mm_unpacklo_epi16(words, zero);
+            b = _mm_unpackhi_epi16(words, zero);
+        }
+    };
+    template<> struct batch<norm<int16_t> >  : public sse_norm_batch<norm<int16_t>,  narrow_snorm16> {};
+    template<> struct batch<norm<uint16_t> > : public sse_norm_batch<norm<uint16_t>, narrow_unorm16> {};
+    template<> struct batch<norm<int8_t> >   : public sse_norm_batch<norm<int8_t>,   narrow_snorm8>  {};
+    template<> struct batch<norm<uint8_t> >  : public sse_norm_batch<norm<uint8_t>,  narrow_unorm8>  {};
+
+    /*
+     * 4 vectors to 4 snorm1010102 : transposed to x[4], y[4], z[4], w[4], each one converted and shifted at once.
+     */
+    inline __m128i snorm1010102Field(__m128 lanes, float max, int mask) noexcept
+    {
+        // -1 second : maxps returns it for NaN lanes, as snorm1010102::field does.
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(lanes, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+        return _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(max))), _mm_set1_epi32(mask));
+    }
+    inline __m128i packSnorm1010102(__m128 a, __m128 b, __m128 c, __m128 d) noexcept
+    {
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        __m128i bits = snorm1010102Field(a, 511.0f, 0x3FF);
+        bits = _mm_or_si128(bits, _mm_slli_epi32(snorm1010102Field(b, 511.0f, 0x3FF), 10));
+        bits = _mm_or_si128(bits, _mm_slli_epi32(snorm1010102Field(c, 511.0f, 0x3FF), 20));
+        return _mm_or_si128(bits, _mm_slli_epi32(snorm1010102Field(d, 1.0f, 0x3), 30));
+    }
+    /*
+     * 4 snorm1010102 to 4 vec4 : each field is sign extended by a left then an arithmetic right shift.
+     */
+    inline void unpackSnorm1010102(__m128i bits, float* out) noexcept
+    {
+        const __m128 low   = _mm_set1_ps(-1.0f);
+        const __m128 scale = _mm_set1_ps(1.0f / 511.0f);
+        __m128 x = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(bits, 22), 22)), scale), low);
+        __m128 y = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(bits, 12), 22)), scale), low);
+        __m128 z = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(bits, 2),  22)), scale), low);
+        __m128 w = _mm_max_ps(_mm_cvtepi32_ps(_mm_srai_epi32(bits, 30)), low);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(out,      x);
+        _mm_storeu_ps(out + 4,  y);
+        _mm_storeu_ps(out + 8,  z);
+        _mm_storeu_ps(out + 12, w);
+    }
+#endif
+}
+//! @endcond
+
+
+/**
+ * @struct PackedVec
+ * @brief N components stored with a compact \b Format, the GPU side counterpart of a Vecf<float, N>.
+ *
+ * It's trivially copyable and tightly packed, so arrays of it can be memcpy'd into vertex buffers.
+ * @code
+ * half2 uv(Texcoords(0.5f, 0.25f));
+ * Texcoords back = uv.unpack();
+ * @endcode
+ */
+template<typename Format, uint32_t N>
+struct PackedVec final
+{
+    public:
+        typedef typename Format::storage_type storage_type; //!< The type of a single stored component.
+
+        /**
+         * @brief Construct a PackedVec filled with the packed 0.
+         */
+        constexpr PackedVec(void) : values{}
+        {
+
+        }
+        /**
+         * @brief Construct a PackedVec by converting \b v.
+         * @param[in] v The values to pack, clamped to the range of \b Format.
+         */
+        explicit PackedVec(const Vecf<float, N>& v) noexcept
+        {
+            _packed::batch<Format>::pack(v, this->values, N);
+        }
+        /**
+         * @brief Converts back this PackedVec into floats.
+         * @return A new Vecf with the unpacked values.
+         */
+        Vecf<float, N> unpack(void) const noexcept
+        {
+            Vecf<float, N> result;
+            _packed::batch<Format>::unpack(this->values, result, N);
+            return result;
+        }
+        /**
+         * @brief Convert this PackedVec into a pointer to its stored components, for a const PackedVec.
+         */
+        operator const storage_type*(void) const noexcept
+        {
+            return this->values;
+        }
+        /**
+         * @brief Convert this PackedVec into a pointer to its stored components.
+         */
+        operator storage_type*(void) noexcept
+        {
+            return this->values;
+        }
+
+    private:
+        storage_type values[N]; //!< The packed components.
+
+        static_assert(N >= 2 && N <= 4, "N of PackedVec must be between 2 and 4 included");
+};
+
+
+/**
+ * @struct snorm1010102
+ * @brief A vec4 packed as 3 signed normalized 10 bits integers and a 2 bits one, x being the lowest bits.
+ * This is the natural format of normals and tangents (w for the bitangent sign), in 4 bytes instead of 12|16.
+ */
+struct snorm1010102 final
+{
+    public:
+        /**
+         * @brief Construct a snorm1010102 filled with 0.
+         */
+        constexpr snorm1010102(void) : bits(0)
+        {
+
+        }
+        /**
+         * @brief Construct a snorm1010102 by converting \b v, clamped to [-1, 1].
+         * @param[in] v The values to pack.
+         */
+        explicit snorm1010102(const vec4& v) noexcept : bits(0)
+        {
+            this->bits = snorm1010102::field(v.x(), 511.0f, 0)  | snorm1010102::field(v.y(), 511.0f, 10)
+                       | snorm1010102::field(v.z(), 511.0f, 20) | snorm1010102::field(v.w(), 1.0f, 30);
+        }
+        /**
+         * @brief Construct a snorm1010102 by converting \b v, clamped to [-1, 1], with w = 0.
+         * @param[in] v The normal to pack.
+         */
+        explicit snorm1010102(const vec3& v) noexcept : snorm1010102(vec4(v, 0.0f))
+        {
+
+        }
+        /**
+         * @brief Converts back this snorm1010102 into floats.
+         * @return A new vec4 with the unpacked values.
+         */
+        vec4 unpack(void) const noexcept
+        {
+            return vec4(snorm1010102::read(this->bits << 22, 511.0f), snorm1010102::read(this->bits << 12, 511.0f),
+                        snorm1010102::read(this->bits << 2,  511.0f), snorm1010102::read(this->bits,       1.0f));
+        }
+        /**
+         * @brief Grants access to the packed bits, as OpenGL reads them.
+         * @return These 32 bits.
+         */
+        inline uint32_t packed(void) const noexcept
+        {
+            return this->bits;
+        }
+
+    private:
+        uint32_t bits; //!< w:2 | z:10 | y:10 | x:10
+
+        //! @brief Packs \b f as a snorm of maximum \b max at bit \b shift.
+        static uint32_t field(float f, float max, uint32_t shift) noexcept
+        {
+            const int32_t value = static_cast<int32_t>(std::nearbyint(std::min(std::max(-1.0f, f), 1.0f) * max));
+            const uint32_t mask = (max > 1.0f) ? 0x3FF : 0x3;
+            return (static_cast<uint32_t>(value) & mask) << shift;
+        }
+        //! @brief Reads the snorm of maximum \b max stored in the highest bits of \b high.
+        static float read(uint32_t high, float max) noexcept
+        {
+            const uint32_t width = (max > 1.0f) ? 22 : 30;
+            const int32_t  value = static_cast<int32_t>(high) >> width;
+            return std::max(static_cast<float>(value) / max, -1.0f);
+        }
+};
+
+
+typedef PackedVec<_packed::half,            2> half2;     //!< 2 half floats.
+typedef PackedVec<_packed::half,            4> half4;     //!< 4 half floats.
+typedef PackedVec<_packed::norm<int8_t>,    2> snorm8x2;  //!< 2 signed   normalized bytes.
+typedef PackedVec<_packed::norm<int8_t>,    4> snorm8x4;  //!< 4 signed   normalized bytes.
+typedef PackedVec<_packed::norm<uint8_t>,   2> unorm8x2;  //!< 2 unsigned normalized bytes.
+typedef PackedVec<_packed::norm<uint8_t>,   4> unorm8x4;  //!< 4 unsigned normalized bytes.
+typedef PackedVec<_packed::norm<int16_t>,   2> snorm16x2; //!< 2 signed   normalized shorts.
+typedef PackedVec<_packed::norm<int16_t>,   4> snorm16x4; //!< 4 signed   normalized shorts.
+typedef PackedVec<_packed::norm<uint16_t>,  2> unorm16x2; //!< 2 unsigned normalized shorts.
+typedef PackedVec<_packed::norm<uint16_t>,  4> unorm16x4; //!< 4 unsigned normalized shorts.
+
+typedef half2        PackedTexcoords; //!< The compact counterpart of Texcoords.
+typedef snorm1010102 PackedNormal;    //!< The compact counterpart of Normal.
+typedef unorm8x4     PackedColor;     //!< The compact counterpart of Color.
+
+static_assert(sizeof(half4) == 8 && sizeof(unorm8x4) == 4 && sizeof(snorm1010102) == 4, "Packed formats must be tight");
+static_assert(std::is_trivially_copyable<half4>::value,        "half4 must stay memcpy-able");
+static_assert(std::is_trivially_copyable<snorm1010102>::value, "snorm1010102 must stay memcpy-able");
+
+
+/**
+ * @brief Converts \b count Vecf into a compact format, with the SIMD path of the format if enabled.
+ * @param[in]  in    The first vector to pack.
+ * @param[out] out   The first packed vector to write.
+ * @param[in]  count The number of vectors.
+ * @pre \b in and \b out must address at least \b count elements.
+ *
+ * @code
+ * std::vector<Texcoords> uvs = mesh.texcoords();
+ * std::vector<half2>     compact(uvs.size());
+ * pack(uvs.data(), compact.data(), uvs.size());
+ * @endcode
+ */
+template<typename Format, uint32_t N>
+void pack(const Vecf<float, N>* in, PackedVec<Format, N>* out, std::size_t count) noexcept
+{
+    static_assert(sizeof(PackedVec<Format, N>) == N*sizeof(typename Format::storage_type), "PackedVec must be tight");
+    const float* src = *in;
+    typename Format::storage_type* dst = *out;
+    _packed::batch<Format>::pack(src, dst, count*N);
+}
+/**
+ * @brief Converts \b count compact vectors back into Vecf.
+ * @param[in]  in    The first packed vector to read.
+ * @param[out] out   The first vector to write.
+ * @param[in]  count The number of vectors.
+ * @pre \b in and \b out must address at least \b count elements.
+ */
+template<typename Format, uint32_t N>
+void unpack(const PackedVec<Format, N>* in, Vecf<float, N>* out, std::size_t count) noexcept
+{
+    const typename Format::storage_type* src = *in;
+    float* dst = *out;
+    _packed::batch<Format>::unpack(src, dst, count*N);
+}
+/**
+ * @brief Converts \b count normals into snorm1010102, with w = 0, 4 at a time with SSE2.
+ * @param[in]  in    The first normal to pack.
+ * @param[out] out   The first packed normal to write.
+ * @param[in]  count The number of normals.
+ * @pre \b in and \b out must address at least \b count elements.
+ */
+inline void pack(const vec3* in, snorm1010102* out, std::size_t count) noexcept
+{
+    std::size_t i = 0;
+#if defined(MTLKIT_SIMD_SSE2)
+    typedef _vec_kernel::sse_float3 Lanes;
+    for(;i+4<=count;i+=4)
+    {
+        __m128i bits = _packed::packSnorm1010102(Lanes::load(in[i]), Lanes::load(in[i+1]), Lanes::load(in[i+2]), Lanes::load(in[i+3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bits);
+    }
+#endif
+    for(;i<count;++i)
+    {
+        out[i] = snorm1010102(in[i]);
+    }
+}
+/**
+ * @brief Converts \b count vec4 into snorm1010102.
+ * @param[in]  in    The first vector to pack.
+ * @param[out] out   The first packed vector to write.
+ * @param[in]  count The number of vectors.
+ * @pre \b in and \b out must address at least \b count elements.
+ */
+inline void pack(const vec4* in, snorm1010102* out, std::size_t count) noexcept
+{
+    std::size_t i = 0;
+#if defined(MTLKIT_SIMD_SSE2)
+    const float* src = *in;
+    for(;i+4<=count;i+=4)
+    {
+        const float* v = src + 4*i;
+        __m128i bits = _packed::packSnorm1010102(_mm_loadu_ps(v), _mm_loadu_ps(v + 4), _mm_loadu_ps(v + 8), _mm_loadu_ps(v + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bits);
+    }
+#endif
+    for(;i<count;++i)
+    {
+        out[i] = snorm1010102(in[i]);
+    }
+}
+/**
+ * @brief Converts \b count snorm1010102 back into vec4.
+ * @param[in]  in    The first packed vector to read.
+ * @param[out] out   The first vector to write.
+ * @param[in]  count The number of vectors.
+ * @pre \b in and \b out must address at least \b count elements.
+ */
+inline void unpack(const snorm1010102* in, vec4* out, std::size_t count) noexcept
+{
+    std::size_t i = 0;
+#if defined(MTLKIT_SIMD_SSE2)
+    float* dst = *out;
+    for(;i+4<=count;i+=4)
+    {
+        _packed::unpackSnorm1010102(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), dst + 4*i);
+    }
+#endif
+    for(;i<count;++i)
+    {
+        out[i] = in[i].unpack();
+    }
+}
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * @file simd.hpp
+ * @brief Selects at compile time the SIMD instruction sets the math headers may use.
+ *
+ * Every path is chosen from the compiler predefined macros (so from -msse2, -mavx, -march=native...).
+ * Define \b MTLKIT_NO_SIMD before including anything to force the scalar code everywhere.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_SIMD_HPP_INCLUDED
+#define MTLKIT_SIMD_HPP_INCLUDED
+
+#if !defined(MTLKIT_NO_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define MTLKIT_SIMD_SSE2 1 //!< 128 bits float/int registers are available.
+        #include <emmintrin.h>
+    #endif
+    #if defined(MTLKIT_SIMD_SSE2) && defined(__SSE4_1__)
+        #define MTLKIT_SIMD_SSE41 1 //!< 32 bits integer min/max/multiply are available.
+        #include <smmintrin.h>
+    #endif
+    #if defined(MTLKIT_SIMD_SSE2) && defined(__AVX__)
+        #define MTLKIT_SIMD_AVX 1  //!< 256 bits float registers are available.
+        #include <immintrin.h>
+    #endif
+    #if defined(MTLKIT_SIMD_SSE2) && defined(__FMA__)
+        #define MTLKIT_SIMD_FMA 1  //!< Fused multiply-add on float registers is available.
+        #include <immintrin.h>
+    #endif
+#endif
+
+#if defined(MTLKIT_SIMD_AVX)
+    #define MTLKIT_SIMD_ALIGNMENT 32 //!< Bytes alignment of the widest register, for aligned loads and stores.
+#else
+    #define MTLKIT_SIMD_ALIGNMENT 16 //!< Bytes alignment of the widest register, for aligned loads and stores.
+#endif
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @file transform.hpp
+ * @brief Defines affine transforms as compact 3x4 matrices, and the usual builders of a scene.
+ *
+ * An affine matrix always ends with the row (0, 0, 0, 1), Transform3 doesn't store it :
+ * it takes 12 floats instead of 16 and its product 36 multiplications instead of 64.
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_TRANSFORM_HPP_INCLUDED
+#define MTLKIT_TRANSFORM_HPP_INCLUDED
+
+#include "mat.hpp"
+#include "quat.hpp"
+#include "simd.hpp"
+#include "vec.hpp"
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _transform // Do not try to use that.
+{
+    /*
+     * Affine products of the 3x4 row major matrices a and b : the missing row (0, 0, 0, 1) of b
+     * only adds the translation of a, so each row of the result is a[i][0]*b0 + a[i][1]*b1 + a[i][2]*b2 + a[i][3]*e3.
+     */
+#if defined(MTLKIT_SIMD_SSE2)
+    inline void compose(const float* a, const float* b, float* out) noexcept
+    {
+        const __m128 b0 = _mm_loadu_ps(b);
+        const __m128 b1 = _mm_loadu_ps(b + 4);
+        const __m128 b2 = _mm_loadu_ps(b + 8);
+        const __m128 e3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+        for(uint32_t i=0;i<3;++i)
+        {
+            const __m128 row = _mm_loadu_ps(a + 4*i);
+            __m128 r = _mm_mul_ps(_mm_shuffle_ps(row, row, 0x00), b0);
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0x55), b1));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xAA), b2));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xFF), e3));
+            _mm_storeu_ps(out + 4*i, r);
+        }
+    }
+    // The 3 dot products of the rows of m with (x, y, z, w), w being 1 for a point and 0 for a vector.
+    inline vec3 apply(const float* m, const vec3& v, float w) noexcept
+    {
+        const __m128 p = _mm_set_ps(w, v[2], v[1], v[0]);
+        __m128 r0 = _mm_mul_ps(_mm_loadu_ps(m),     p);
+        __m128 r1 = _mm_mul_ps(_mm_loadu_ps(m + 4), p);
+        __m128 r2 = _mm_mul_ps(_mm_loadu_ps(m + 8), p);
+        __m128 r3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        float result[4];
+        _mm_storeu_ps(result, _mm_add_ps(_mm_add_ps(r0, r1), _mm_add_ps(r2, r3)));
+        return vec3(result[0], result[1], result[2]);
+    }
+#else
+    inline void compose(const float* a, const float* b, float* out) noexcept
+    {
+        for(uint32_t i=0;i<3;++i)
+        {
+            for(uint32_t j=0;j<4;++j)
+            {
+                out[4*i + j] = a[4*i]*b[j] + a[4*i + 1]*b[4 + j] + a[4*i + 2]*b[8 + j] + ((j == 3) ? a[4*i + 3] : 0.0f);
+            }
+        }
+    }
+    inline vec3 apply(const float* m, const vec3& v, float w) noexcept
+    {
+        float result[3];
+        for(uint32_t i=0;i<3;++i)
+        {
+            result[i] = m[4*i]*v[0] + m[4*i + 1]*v[1] + m[4*i + 2]*v[2] + m[4*i + 3]*w;
+        }
+        return vec3(result[0], result[1], result[2]);
+    }
+#endif
+}
+//! @endcond
+
+
+/**
+ * @class Transform3
+ * @brief An affine transform of the 3D space : a linear part (rotation, scale, shear) then a translation.
+ * @details Its 3 rows are stored as a row major Matrix<float, 3, 4>, so each one fills a SSE register.
+ * Use toMat4() to upload it.
+ *
+ * @code
+ * const Transform3 model = Transform3::translation(position).rotate(orientation).scale(vec3(2.0f, 2.0f, 2.0f));
+ * glUniformMatrix4fv(location, 1, GL_FALSE, model.toMat4().data());
+ * @endcode
+ */
+class Transform3 final
+{
+    public:
+        typedef Matrix<float, 3, 4, RowMajor> Storage; //!< The 3 first rows of the 4x4 matrix.
+
+        //! @brief Construct the identity transform.
+        constexpr Transform3(void) noexcept : _matrix(Storage::identity())
+        {
+
+        }
+        /**
+         * @brief Construct a transform from the 3 first rows of its 4x4 matrix.
+         * @param[in] matrix The rows, the last column being the translation.
+         */
+        constexpr explicit Transform3(const Storage& matrix) noexcept : _matrix(matrix)
+        {
+
+        }
+        /**
+         * @brief Construct the translation by \b offset.
+         * @param[in] offset The translation.
+         * @return The new transform.
+         */
+        static Transform3 translation(const vec3& offset) noexcept;
+        /**
+         * @brief Construct the rotation of \b radians around \b axis.
+         * @param[in] axis    The rotation axis, which must be normalized.
+         * @param[in] radians The counterclockwise angle.
+         * @return The new transform.
+         */
+        static Transform3 rotation(const vec3& axis, float radians) noexcept;
+        /**
+         * @brief Construct the rotation \b q.
+         * @param[in] q The rotation, which must be normalized.
+         * @return The new transform.
+         */
+        static Transform3 rotation(const Quat& q) noexcept;
+        /**
+         * @brief Construct the scale by \b factors along each axis.
+         * @param[in] factors The scale along x, y and z.
+         * @return The new transform.
+         */
+        static Transform3 scaling(const vec3& factors) noexcept;
+        /**
+         * @brief Construct the view transform of a camera at \b eye looking at \b target (gluLookAt).
+         * @param[in] eye    The position of the camera.
+         * @param[in] target The point in the middle of the screen.
+         * @param[in] up     The up direction, which mustn't be parallel to \b target - \b eye.
+         * @return The transform from the world to the camera space, looking down -z.
+         */
+        static Transform3 lookAt(const vec3& eye, const vec3& target, const vec3& up) noexcept;
+        /**
+         * @brief Construct the orthographic projection of the box [left, right]x[bottom, top]x[-zNear, -zFar]
+         * into [-1, 1]^3 (glOrtho), which is affine.
+         * @return The new transform.
+         * @pre \b left != \b right, \b bottom != \b top, \b zNear != \b zFar.
+         */
+        static Transform3 ortho(float left, float right, float bottom, float top, float zNear, float zFar) noexcept;
+        /**
+         * @brief Applies the translation by \b offset before this transform.
+         * @param[in] offset The translation.
+         * @return *this * translation(\b offset).
+         */
+        Transform3 translate(const vec3& offset) const noexcept;
+        /**
+         * @brief Applies the rotation \b q before this transform.
+         * @param[in] q The rotation, which must be normalized.
+         * @return *this * rotation(\b q).
+         */
+        Transform3 rotate(const Quat& q) const noexcept;
+        /**
+         * @brief Applies the scale by \b factors before this transform.
+         * @param[in] factors The scale along x, y and z.
+         * @return *this * scaling(\b factors).
+         */
+        Transform3 scale(const vec3& factors) const noexcept;
+        /**
+         * @brief Grants access to the 3 rows of the matrix.
+         * @return A reference to the storage of this transform.
+         */
+        constexpr const Storage& matrix(void) const noexcept
+        {
+            return this->_matrix;
+        }
+        /**
+         * @brief Transforms the point \b p, the translation applies.
+         * @param[in] p The point.
+         * @return The transformed point.
+         */
+        vec3 transformPoint(const vec3& p) const noexcept
+        {
+            return _transform::apply(this->_matrix.data(), p, 1.0f);
+        }
+        /**
+         * @brief Transforms the direction \b v, the translation doesn't apply.
+         * @param[in] v The direction, which isn't normalized back.
+         * @return The transformed direction.
+         */
+        vec3 transformVector(const vec3& v) const noexcept
+        {
+            return _transform::apply(this->_matrix.data(), v, 0.0f);
+        }
+        /**
+         * @brief Computes the inverse transform, with the inverse of the linear part only.
+         * @return A new transform whose composition with this one is the identity.
+         * @throw std::runtime_error If the linear part is singular.
+         */
+        Transform3 inverse(void) const;
+        /**
+         * @brief Promotes this transform to a full 4x4 matrix, column major as glUniformMatrix4fv expects it.
+         * @return The matrix, ending with the row (0, 0, 0, 1).
+         */
+        mat4 toMat4(void) const noexcept;
+
+    private:
+        Storage _matrix; //!< The 3 first rows, the last column being the translation.
+};
+
+static_assert(sizeof(Transform3) == 12*sizeof(float), "Transform3 must be tightly packed to be batched");
+static_assert(std::is_trivially_copyable<Transform3>::value, "Transform3 must stay memcpy-able");
+
+/**
+ * @brief Composes two transforms : \b t1 * \b t2 applies \b t2 first, then \b t1.
+ * @param[in] t1 The second transform.
+ * @param[in] t2 The first  transform.
+ * @return The affine product of \b t1 and \b t2.
+ */
+inline Transform3 operator*(const Transform3& t1, const Transform3& t2) noexcept
+{
+    Transform3::Storage result;
+    _transform::compose(t1.matrix().data(), t2.matrix().data(), result.data());
+    return Transform3(result);
+}
+/**
+ * @brief Applies \b t to the point \b p, as transformPoint().
+ * @param[in] t The transform.
+ * @param[in] p The point.
+ * @return The transformed point.
+ */
+inline vec3 operator*(const Transform3& t, const vec3& p) noexcept
+{
+    return t.transformPoint(p);
+}
+/**
+ * @brief Computes the perspective projection (gluPerspective), which isn't affine so it's a mat4.
+ * @param[in] fovy   The vertical field of view, in radians.
+ * @param[in] aspect The width over the height of the viewport.
+ * @param[in] zNear  The distance of the near plane, strictly positive.
+ * @param[in] zFar   The distance of the far plane, greater than \b zNear.
+ * @return The projection, mapping the view frustum into [-1, 1]^3.
+ */
+mat4 perspective(float fovy, float aspect, float zNear, float zFar) noexcept;
+
+#endif
@@ -8,29 +8,699 @@
 #define MTLKIT_VEC_HPP_INCLUDED
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 #include <type_traits>
 #include <iostream>
 
+#include "meta.hpp"
+#include "simd.hpp"
+
+
+template<typename T, uint32_t N> struct Vecf;
+template<typename T, uint32_t N, std::size_t A> struct AlignedVecf;
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _vec_kernel // Do not try to use that.
+{
+    /*
+     * The scalar implementation of the Vecf operators, working on raw lanes.
+     * Every Vecf without a dedicated specialization below ends up here, and the specializations
+     * inherit the operations they don't accelerate (integer division, dvec cross...).
+     */
+    template<typename T, uint32_t N> struct kernel;
+    template<typename T, uint32_t N>
+    struct scalar_kernel
+    {
+        static void add(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] + b[i];
+            }
+        }
+        static void sub(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] - b[i];
+            }
+        }
+        static void scale(const T* a, T f, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] * f;
+            }
+        }
+        static void divide(const T* a, T f, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] / f;
+            }
+        }
+        static bool equal(const T* a, const T* b) noexcept
+        {
+            return scalar_kernel<T, N>::equal(a, b, std::is_integral<T>());
+        }
+        // Integers are compared exactly, a - b would wrap for unsigned ones.
+        static bool equal(const T* a, const T* b, std::true_type) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                if (a[i] != b[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        static bool equal(const T* a, const T* b, std::false_type) noexcept
+        {
+            const float EPSILON = 0.0001;
+            for(uint32_t i=0;i<N;++i)
+            {
+                if (std::abs(a[i] - b[i]) > EPSILON)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        static T dot(const T* a, const T* b) noexcept
+        {
+            T sum = T();
+            for(uint32_t i=0;i<N;++i)
+            {
+                sum += a[i] * b[i];
+            }
+            return sum;
+        }
+        static void cross(const T* a, const T* b, T* out) noexcept
+        {
+            const T x = a[1]*b[2] - a[2]*b[1];
+            const T y = a[2]*b[0] - a[0]*b[2];
+            const T z = a[0]*b[1] - a[1]*b[0];
+            out[0] = x;
+            out[1] = y;
+            out[2] = z;
+        }
+        static void normalize(const T* a, T* out) noexcept
+        {
+            const T length = std::sqrt(kernel<T, N>::dot(a, a));
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] / length;
+            }
+        }
+        // Without rsqrt instructions, the fast versions are the exact ones.
+        static T fastLength(const T* a) noexcept
+        {
+            return std::sqrt(kernel<T, N>::dot(a, a));
+        }
+        static void fastNormalize(const T* a, T* out) noexcept
+        {
+            kernel<T, N>::normalize(a, out);
+        }
+        static void min(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = (b[i] < a[i]) ? b[i] : a[i];
+            }
+        }
+        static void max(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = (a[i] < b[i]) ? b[i] : a[i];
+            }
+        }
+        static void bitAnd(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] & b[i];
+            }
+        }
+        static void bitOr(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] | b[i];
+            }
+        }
+        static void bitXor(const T* a, const T* b, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] ^ b[i];
+            }
+        }
+        static void bitNot(const T* a, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = ~a[i];
+            }
+        }
+        static void shiftLeft(const T* a, uint32_t n, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] << n;
+            }
+        }
+        static void shiftRight(const T* a, uint32_t n, T* out) noexcept
+        {
+            for(uint32_t i=0;i<N;++i)
+            {
+                out[i] = a[i] >> n;
+            }
+        }
+    };
+    template<typename T, uint32_t N>
+    struct kernel : public scalar_kernel<T, N> {};
+    /*
+     * Gathers the lanes L... of a Vecf<T, N> into a new Vecf, resolved at compile time.
+     */
+    template<typename T, uint32_t N, uint32_t... L>
+    struct swizzle
+    {
+        static constexpr Vecf<T, sizeof...(L)> apply(const Vecf<T, N>& v) noexcept
+        {
+            return Vecf<T, sizeof...(L)>(v.template lane<L>()...);
+        }
+    };
+#if defined(MTLKIT_SIMD_SSE2)
+    /*
+     * Loads/stores a vec4 as a whole register.
+     */
+    struct sse_float4
+    {
+        static const int MASK = 0xF;
+        static __m128 load(const float* p) noexcept {return _mm_loadu_ps(p);}
+        static void store(float* p, __m128 v) noexcept {_mm_storeu_ps(p, v);}
+    };
+    /*
+     * Loads a vec3 into a register padded with a 0 lane, and only writes back the 3 first lanes,
+     * so the memory layout of vec3 stays 3 tightly packed floats.
+     */
+    struct sse_float3
+    {
+        static const int MASK = 0x7;
+        static __m128 load(const float* p) noexcept
+        {
+            __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+            return _mm_movelh_ps(xy, _mm_load_ss(p + 2));
+        }
+        static void store(float* p, __m128 v) noexcept
+        {
+            _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+            _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+        }
+    };
+    /*
+     * The SSE2 implementation, the Lanes policy tells how to move the data in and out of a register.
+     */
+    template<typename Lanes>
+    struct sse_kernel
+    {
+        static void add(const float* a, const float* b, float* out) noexcept
+        {
+            Lanes::store(out, _mm_add_ps(Lanes::load(a), Lanes::load(b)));
+        }
+        static void sub(const float* a, const float* b, float* out) noexcept
+        {
+            Lanes::store(out, _mm_sub_ps(Lanes::load(a), Lanes::load(b)));
+        }
+        static void scale(const float* a, float f, float* out) noexcept
+        {
+            Lanes::store(out, _mm_mul_ps(Lanes::load(a), _mm_set1_ps(f)));
+        }
+        static void divide(const float* a, float f, float* out) noexcept
+        {
+            Lanes::store(out, _mm_div_ps(Lanes::load(a), _mm_set1_ps(f)));
+        }
+        static bool equal(const float* a, const float* b) noexcept
+        {
+            const __m128 ABS_MASK = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            __m128 delta = _mm_and_ps(_mm_sub_ps(Lanes::load(a), Lanes::load(b)), ABS_MASK);
+            return (_mm_movemask_ps(_mm_cmpgt_ps(delta, _mm_set1_ps(0.0001f))) & Lanes::MASK) == 0;
+        }
+        // The dot product of a and b, broadcast over the 4 lanes (the padding lane of a vec3 is 0).
+        static __m128 dot4(__m128 a, __m128 b) noexcept
+        {
+            __m128 products = _mm_mul_ps(a, b);
+            __m128 sums     = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_add_ps(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+        // rsqrtps gives 12 bits, one Newton-Raphson step y' = y * (1.5 - 0.5 * x * y * y) brings ~22.
+        static __m128 fastInverseSqrt(__m128 x) noexcept
+        {
+            __m128 y = _mm_rsqrt_ps(x);
+            __m128 t = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), _mm_mul_ps(y, y));
+            return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), t));
+        }
+        static float dot(const float* a, const float* b) noexcept
+        {
+            return _mm_cvtss_f32(sse_kernel<Lanes>::dot4(Lanes::load(a), Lanes::load(b)));
+        }
+        static void cross(const float* a, const float* b, float* out) noexcept
+        {
+            const __m128 va = Lanes::load(a);
+            const __m128 vb = Lanes::load(b);
+            const __m128 a_yzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 b_yzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+            // a x b = (a * b.yzx - a.yzx * b).yzx
+            const __m128 c = _mm_sub_ps(_mm_mul_ps(va, b_yzx), _mm_mul_ps(a_yzx, vb));
+            sse_float3::store(out, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+        }
+        static void normalize(const float* a, float* out) noexcept
+        {
+            const __m128 va = Lanes::load(a);
+            Lanes::store(out, _mm_div_ps(va, _mm_sqrt_ps(sse_kernel<Lanes>::dot4(va, va))));
+        }
+        static float fastLength(const float* a) noexcept
+        {
+            const __m128 va      = Lanes::load(a);
+            const __m128 squared = sse_kernel<Lanes>::dot4(va, va);
+            const __m128 length  = _mm_mul_ps(squared, sse_kernel<Lanes>::fastInverseSqrt(squared));
+            // x * rsqrt(x) is NaN for x = 0 where the length is 0.
+            return _mm_cvtss_f32(_mm_and_ps(length, _mm_cmpneq_ps(squared, _mm_setzero_ps())));
+        }
+        static void fastNormalize(const float* a, float* out) noexcept
+        {
+            const __m128 va = Lanes::load(a);
+            Lanes::store(out, _mm_mul_ps(va, sse_kernel<Lanes>::fastInverseSqrt(sse_kernel<Lanes>::dot4(va, va))));
+        }
+        static void min(const float* a, const float* b, float* out) noexcept
+        {
+            Lanes::store(out, _mm_min_ps(Lanes::load(a), Lanes::load(b)));
+        }
+        static void max(const float* a, const float* b, float* out) noexcept
+        {
+            Lanes::store(out, _mm_max_ps(Lanes::load(a), Lanes::load(b)));
+        }
+    };
+    template<> struct kernel<float, 4> : public sse_kernel<sse_float4> {};
+    template<> struct kernel<float, 3> : public sse_kernel<sse_float3> {};
+    /*
+     * Swizzles of vec3/vec4 into vec3/vec4 are a single shufps.
+     */
+    template<typename In, typename Out, uint32_t N, uint32_t M, int SHUFFLE>
+    struct sse_swizzle
+    {
+        static Vecf<float, M> apply(const Vecf<float, N>& v) noexcept
+        {
+            Vecf<float, M> result;
+            __m128 lanes = In::load(v);
+            Out::store(result, _mm_shuffle_ps(lanes, lanes, SHUFFLE));
+            return result;
+        }
+    };
+    template<uint32_t A, uint32_t B, uint32_t C, uint32_t D>
+    struct swizzle<float, 4, A, B, C, D> : public sse_swizzle<sse_float4, sse_float4, 4, 4, _MM_SHUFFLE(D, C, B, A)> {};
+    template<uint32_t A, uint32_t B, uint32_t C>
+    struct swizzle<float, 4, A, B, C>    : public sse_swizzle<sse_float4, sse_float3, 4, 3, _MM_SHUFFLE(C, C, B, A)> {};
+    template<uint32_t A, uint32_t B, uint32_t C, uint32_t D>
+    struct swizzle<float, 3, A, B, C, D> : public sse_swizzle<sse_float3, sse_float4, 3, 4, _MM_SHUFFLE(D, C, B, A)> {};
+    template<uint32_t A, uint32_t B, uint32_t C>
+    struct swizzle<float, 3, A, B, C>    : public sse_swizzle<sse_float3, sse_float3, 3, 3, _MM_SHUFFLE(C, C, B, A)> {};
+    /*
+     * Loads/stores an ivec4|uvec4 as a whole register.
+     */
+    struct sse_int4
+    {
+        static const uint32_t SIZE = 4;
+        static const int MASK = 0xF;
+        static __m128i load(const void* p) noexcept {return _mm_loadu_si128(static_cast<const __m128i*>(p));}
+        static void store(void* p, __m128i v) noexcept {_mm_storeu_si128(static_cast<__m128i*>(p), v);}
+    };
+    /*
+     * Same as sse_float3 for ivec3|uvec3 : padded with a 0 lane in register, 3 lanes in memory.
+     */
+    struct sse_int3
+    {
+        static const uint32_t SIZE = 3;
+        static const int MASK = 0x7;
+        static __m128i load(const void* p) noexcept
+        {
+            const int32_t* lanes = static_cast<const int32_t*>(p);
+            __m128i xy = _mm_loadl_epi64(static_cast<const __m128i*>(p));
+            return _mm_unpacklo_epi64(xy, _mm_cvtsi32_si128(lanes[2]));
+        }
+        static void store(void* p, __m128i v) noexcept
+        {
+            int32_t* lanes = static_cast<int32_t*>(p);
+            _mm_storel_epi64(static_cast<__m128i*>(p), v);
+            lanes[2] = _mm_cvtsi128_si32(_mm_unpackhi_epi64(v, v));
+        }
+    };
+    /*
+     * What depends on the signedness of 32 bits integer lanes : right shift, ordering, min and max.
+     * SSE2 only has signed comparisons, unsigned ones flip the sign bits first.
+     */
+    template<typename T>
+    struct sse_int32
+    {
+        static __m128i shiftRight(__m128i a, __m128i n) noexcept {return _mm_sra_epi32(a, n);}
+        static __m128i greater(__m128i a, __m128i b) noexcept {return _mm_cmpgt_epi32(a, b);}
+#if defined(MTLKIT_SIMD_SSE41)
+        static __m128i min(__m128i a, __m128i b) noexcept {return _mm_min_epi32(a, b);}
+        static __m128i max(__m128i a, __m128i b) noexcept {return _mm_max_epi32(a, b);}
+#endif
+    };
+    template<>
+    struct sse_int32<uint32_t>
+    {
+        static __m128i shiftRight(__m128i a, __m128i n) noexcept {return _mm_srl_epi32(a, n);}
+        static __m128i greater(__m128i a, __m128i b) noexcept
+        {
+            const __m128i SIGN = _mm_set1_epi32(static_cast<int32_t>(0x80000000u));
+            return _mm_cmpgt_epi32(_mm_xor_si128(a, SIGN), _mm_xor_si128(b, SIGN));
+        }
+#if defined(MTLKIT_SIMD_SSE41)
+        static __m128i min(__m128i a, __m128i b) noexcept {return _mm_min_epu32(a, b);}
+        static __m128i max(__m128i a, __m128i b) noexcept {return _mm_max_epu32(a, b);}
+#endif
+    };
+    /*
+     * The SSE2 implementation for ivec3|4 and uvec3|4, the division stays scalar (there is no instruction for it).
+     */
+    template<typename T, typename Lanes>
+    struct sse_int_kernel : public scalar_kernel<T, Lanes::SIZE>
+    {
+        typedef sse_int32<T> Ops;
+
+        static __m128i mul(__m128i a, __m128i b) noexcept
+        {
+#if defined(MTLKIT_SIMD_SSE41)
+            return _mm_mullo_epi32(a, b);
+#else
+            // pmuludq multiplies the even lanes into 64 bits, the low 32 bits are the same signed or not.
+            __m128i even = _mm_mul_epu32(a, b);
+            __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                      _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+        }
+        static __m128i select(__m128i mask, __m128i a, __m128i b) noexcept
+        {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+        static void add(const T* a, const T* b, T* out) noexcept
+        {
+            Lanes::store(out, _mm_add_epi32(Lanes::load(a), Lanes::load(b)));
+        }
+        static void sub(const T* a, const T* b, T* out) noexcept
+        {
+            Lanes::store(out, _mm_sub_epi32(Lanes::load(a), Lanes::load(b)));
+        }
+        static void scale(const T* a, T f, T* out) noexcept
+        {
+            Lanes::store(out, sse_int_kernel<T, Lanes>::mul(Lanes::load(a), _mm_set1_epi32(static_cast<int32_t>(f))));
+        }
+        static bool equal(const T* a, const T* b) noexcept
+        {
+            __m128i same = _mm_cmpeq_epi32(Lanes::load(a), Lanes::load(b));
+            return (_mm_movemask_ps(_mm_castsi128_ps(same)) & Lanes::MASK) == Lanes::MASK;
+        }
+        static T dot(const T* a, const T* b) noexcept
+        {
+            __m128i products = sse_int_kernel<T, Lanes>::mul(Lanes::load(a), Lanes::load(b));
+            __m128i sums     = _mm_add_epi32(products, _mm_shuffle_epi32(products, _MM_SHUFFLE(2, 3, 0, 1)));
+            sums             = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+            return static_cast<T>(_mm_cvtsi128_si32(sums));
+        }
+        static void min(const T* a, const T* b, T* out) noexcept
+        {
+            const __m128i va = Lanes::load(a), vb = Lanes::load(b);
+#if defined(MTLKIT_SIMD_SSE41)
+            Lanes::store(out, Ops::min(va, vb));
+#else
+            Lanes::store(out, sse_int_kernel<T, Lanes>::select(Ops::greater(va, vb), vb, va));
+#endif
+        }
+        static void max(const T* a, const T* b, T* out) noexcept
+        {
+            const __m128i va = Lanes::load(a), vb = Lanes::load(b);
+#if defined(MTLKIT_SIMD_SSE41)
+            Lanes::store(out, Ops::max(va, vb));
+#else
+            Lanes::store(out, sse_int_kernel<T, Lanes>::select(Ops::greater(va, vb), va, vb));
+#endif
+        }
+        static void bitAnd(const T* a, const T* b, T* out) noexcept
+        {
+            Lanes::store(out, _mm_and_si128(Lanes::load(a), Lanes::load(b)));
+        }
+        static void bitOr(const T* a, const T* b, T* out) noexcept
+        {
+            Lanes::store(out, _mm_or_si128(Lanes::load(a), Lanes::load(b)));
+        }
+        static void bitXor(const T* a, const T* b, T* out) noexcept
+        {
+            Lanes::store(out, _mm_xor_si128(Lanes::load(a), Lanes::load(b)));
+        }
+        static void bitNot(const T* a, T* out) noexcept
+        {
+            Lanes::store(out, _mm_xor_si128(Lanes::load(a), _mm_set1_epi32(-1)));
+        }
+        static void shiftLeft(const T* a, uint32_t n, T* out) noexcept
+        {
+            Lanes::store(out, _mm_sll_epi32(Lanes::load(a), _mm_cvtsi32_si128(static_cast<int32_t>(n))));
+        }
+        static void shiftRight(const T* a, uint32_t n, T* out) noexcept
+        {
+            Lanes::store(out, Ops::shiftRight(Lanes::load(a), _mm_cvtsi32_si128(static_cast<int32_t>(n))));
+        }
+    };
+    template<> struct kernel<int32_t,  4> : public sse_int_kernel<int32_t,  sse_int4> {};
+    template<> struct kernel<int32_t,  3> : public sse_int_kernel<int32_t,  sse_int3> {};
+    template<> struct kernel<uint32_t, 4> : public sse_int_kernel<uint32_t, sse_int4> {};
+    template<> struct kernel<uint32_t, 3> : public sse_int_kernel<uint32_t, sse_int3> {};
+#endif
+#if defined(MTLKIT_SIMD_AVX)
+    /*
+     * Loads/stores a dvec4 as a whole ymm register.
+     */
+    struct avx_double4
+    {
+        static const uint32_t SIZE = 4;
+        static const int MASK = 0xF;
+        static __m256d load(const double* p) noexcept {return _mm256_loadu_pd(p);}
+        static void store(double* p, __m256d v) noexcept {_mm256_storeu_pd(p, v);}
+    };
+    /*
+     * Loads a dvec3 padded with a 0 lane, the masked store never touches the 4th double.
+     */
+    struct avx_double3
+    {
+        static const uint32_t SIZE = 3;
+        static const int MASK = 0x7;
+        static __m256i lanes(void) noexcept {return _mm256_set_epi64x(0, -1, -1, -1);}
+        static __m256d load(const double* p) noexcept {return _mm256_maskload_pd(p, avx_double3::lanes());}
+        static void store(double* p, __m256d v) noexcept {_mm256_maskstore_pd(p, avx_double3::lanes(), v);}
+    };
+    /*
+     * The AVX implementation for dvec3|4, the cross product and the fast versions stay scalar.
+     */
+    template<typename Lanes>
+    struct avx_kernel : public scalar_kernel<double, Lanes::SIZE>
+    {
+        // The dot product of a and b, in the lowest lane.
+        static __m128d dot4(__m256d a, __m256d b) noexcept
+        {
+            __m256d products = _mm256_mul_pd(a, b);
+            __m128d sums     = _mm_add_pd(_mm256_castpd256_pd128(products), _mm256_extractf128_pd(products, 1));
+            return _mm_add_sd(sums, _mm_unpackhi_pd(sums, sums));
+        }
+        static void add(const double* a, const double* b, double* out) noexcept
+        {
+            Lanes::store(out, _mm256_add_pd(Lanes::load(a), Lanes::load(b)));
+        }
+        static void sub(const double* a, const double* b, double* out) noexcept
+        {
+            Lanes::store(out, _mm256_sub_pd(Lanes::load(a), Lanes::load(b)));
+        }
+        static void scale(const double* a, double f, double* out) noexcept
+        {
+            Lanes::store(out, _mm256_mul_pd(Lanes::load(a), _mm256_set1_pd(f)));
+        }
+        static void divide(const double* a, double f, double* out) noexcept
+        {
+            Lanes::store(out, _mm256_div_pd(Lanes::load(a), _mm256_set1_pd(f)));
+        }
+        static bool equal(const double* a, const double* b) noexcept
+        {
+            __m256d delta = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(Lanes::load(a), Lanes::load(b)));
+            return (_mm256_movemask_pd(_mm256_cmp_pd(delta, _mm256_set1_pd(0.0001f), _CMP_GT_OQ)) & Lanes::MASK) == 0;
+        }
+        static double dot(const double* a, const double* b) noexcept
+        {
+            return _mm_cvtsd_f64(avx_kernel<Lanes>::dot4(Lanes::load(a), Lanes::load(b)));
+        }
+        static void normalize(const double* a, double* out) noexcept
+        {
+            const __m256d va     = Lanes::load(a);
+            const double  length = std::sqrt(_mm_cvtsd_f64(avx_kernel<Lanes>::dot4(va, va)));
+            Lanes::store(out, _mm256_div_pd(va, _mm256_set1_pd(length)));
+        }
+        static void min(const double* a, const double* b, double* out) noexcept
+        {
+            Lanes::store(out, _mm256_min_pd(Lanes::load(a), Lanes::load(b)));
+        }
+        static void max(const double* a, const double* b, double* out) noexcept
+        {
+            Lanes::store(out, _mm256_max_pd(Lanes::load(a), Lanes::load(b)));
+        }
+    };
+    template<> struct kernel<double, 4> : public avx_kernel<avx_double4> {};
+    template<> struct kernel<double, 3> : public avx_kernel<avx_double3> {};
+#endif
+}
+//! @endcond
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _vec_detail // Do not try to use that.
+{
+    /*
+     * How many values an argument of the Vecf constructor brings.
+     */
+    template<typename A>                struct arity             : public std::integral_constant<uint32_t, 1> {};
+    template<typename T, uint32_t V>    struct arity<Vecf<T, V>> : public std::integral_constant<uint32_t, V> {};
+    template<typename T, uint32_t V, std::size_t A>
+    struct arity<AlignedVecf<T, V, A>> : public std::integral_constant<uint32_t, V> {};
+    /*
+     * A single Vecf bigger than N : converting it drops its last values, so it must be explicit.
+     */
+    template<uint32_t N, typename... Args> struct narrowing : public std::false_type {};
+    template<uint32_t N, typename A>
+    struct narrowing<N, A> : public std::integral_constant<bool, (arity<A>::value > N)> {};
+    /*
+     * The result of an operator between a Vecf<T, N> and the scalar S, which is converted to T.
+     * Scaling an integer Vecf by a floating point would silently truncate the factor, so it's refused.
+     */
+    template<typename T, uint32_t N, typename S>
+    struct scalar_result : public std::enable_if<std::is_arithmetic<S>::value, Vecf<T, N>>
+    {
+        static_assert(!std::is_arithmetic<S>::value || std::is_floating_point<T>::value || std::is_integral<S>::value,
+                      "An integer Vecf can't be scaled by a floating point, convert the Vecf first");
+    };
+    /*
+     * Tags of the two Vecf constructions : only numerics which fit (every value is written directly),
+     * or anything else (each value is fetched by its index across the arguments).
+     */
+    struct flat {};
+    template<uint32_t N, typename... Args> struct all_numerics;
+    template<uint32_t N>
+    struct all_numerics<N> : public std::true_type {};
+    template<uint32_t N, typename A, typename... Args>
+    struct all_numerics<N, A, Args...> : public std::integral_constant<bool,
+        std::is_arithmetic<A>::value && all_numerics<N, Args...>::value> {};
+    /*
+     * Checks that every requested lane exists within a Vecf of size N.
+     */
+    template<uint32_t N, uint32_t... L> struct all_lower;
+    template<uint32_t N>
+    struct all_lower<N> : public std::true_type {};
+    template<uint32_t N, uint32_t L, uint32_t... Others>
+    struct all_lower<N, L, Others...> : public std::integral_constant<bool, (L < N) && all_lower<N, Others...>::value> {};
+    template<uint32_t N, typename... Args>
+    struct construction
+    {
+        typedef typename std::conditional<sizeof...(Args) <= N && all_numerics<N, Args...>::value,
+            flat, typename _meta::make_indices<N>::type>::type type;
+    };
+}
+//! @endcond
+
+
+//! @cond SKIP_THIS_DOXYGEN
+/*
+ * Generates every named swizzle of 2, 3 and 4 lanes taken among a set of 4 names (xyzw, rgba).
+ * The lane of a name is given by MTLKIT_VEC_LANE_<name>.
+ */
+#define MTLKIT_VEC_LANE_x 0
+#define MTLKIT_VEC_LANE_y 1
+#define MTLKIT_VEC_LANE_z 2
+#define MTLKIT_VEC_LANE_w 3
+#define MTLKIT_VEC_LANE_r 0
+#define MTLKIT_VEC_LANE_g 1
+#define MTLKIT_VEC_LANE_b 2
+#define MTLKIT_VEC_LANE_a 3
+#define MTLKIT_VEC_SWIZZLE2(A, B) \
+    constexpr Vecf<T, 2> A##B(void) const \
+    {return this->template swizzle<MTLKIT_VEC_LANE_##A, MTLKIT_VEC_LANE_##B>();}
+#define MTLKIT_VEC_SWIZZLE3(A, B, C) \
+    constexpr Vecf<T, 3> A##B##C(void) const \
+    {return this->template swizzle<MTLKIT_VEC_LANE_##A, MTLKIT_VEC_LANE_##B, MTLKIT_VEC_LANE_##C>();}
+#define MTLKIT_VEC_SWIZZLE4(A, B, C, D) \
+    constexpr Vecf<T, 4> A##B##C##D(void) const \
+    {return this->template swizzle<MTLKIT_VEC_LANE_##A, MTLKIT_VEC_LANE_##B, MTLKIT_VEC_LANE_##C, MTLKIT_VEC_LANE_##D>();}
+#define MTLKIT_VEC_SWIZZLES_4(X, Y, Z, W, A, B, C) \
+    MTLKIT_VEC_SWIZZLE4(A, B, C, X) MTLKIT_VEC_SWIZZLE4(A, B, C, Y) \
+    MTLKIT_VEC_SWIZZLE4(A, B, C, Z) MTLKIT_VEC_SWIZZLE4(A, B, C, W)
+#define MTLKIT_VEC_SWIZZLES_3(X, Y, Z, W, A, B) \
+    MTLKIT_VEC_SWIZZLE3(A, B, X) MTLKIT_VEC_SWIZZLE3(A, B, Y) \
+    MTLKIT_VEC_SWIZZLE3(A, B, Z) MTLKIT_VEC_SWIZZLE3(A, B, W) \
+    MTLKIT_VEC_SWIZZLES_4(X, Y, Z, W, A, B, X) MTLKIT_VEC_SWIZZLES_4(X, Y, Z, W, A, B, Y) \
+    MTLKIT_VEC_SWIZZLES_4(X, Y, Z, W, A, B, Z) MTLKIT_VEC_SWIZZLES_4(X, Y, Z, W, A, B, W)
+#define MTLKIT_VEC_SWIZZLES_2(X, Y, Z, W, A) \
+    MTLKIT_VEC_SWIZZLE2(A, X) MTLKIT_VEC_SWIZZLE2(A, Y) \
+    MTLKIT_VEC_SWIZZLE2(A, Z) MTLKIT_VEC_SWIZZLE2(A, W) \
+    MTLKIT_VEC_SWIZZLES_3(X, Y, Z, W, A, X) MTLKIT_VEC_SWIZZLES_3(X, Y, Z, W, A, Y) \
+    MTLKIT_VEC_SWIZZLES_3(X, Y, Z, W, A, Z) MTLKIT_VEC_SWIZZLES_3(X, Y, Z, W, A, W)
+#define MTLKIT_VEC_SWIZZLES(X, Y, Z, W) \
+    MTLKIT_VEC_SWIZZLES_2(X, Y, Z, W, X) MTLKIT_VEC_SWIZZLES_2(X, Y, Z, W, Y) \
+    MTLKIT_VEC_SWIZZLES_2(X, Y, Z, W, Z) MTLKIT_VEC_SWIZZLES_2(X, Y, Z, W, W)
+//! @endcond
+
 
 /**
  * @struct Vecf
  * @brief A basic implementation to get vec2,3,4 inside the application.
  */
 template<typename T, uint32_t N>
-struct Vecf final
+struct Vecf
 {
     public:
         Vecf(const Vecf<T, N>& other) = default;
+        Vecf(Vecf<T, N>&& other)      = default;
         /**
-         * @brief Construct a Vecf with variable arguments.
+         * @brief Construct a Vecf with variable arguments, numerics and/or Vecf, GLSL style.
+         * Missing values are set to T(), the extra ones are ignored.
          * @param[in] args Every arguments being passed to the function.
+         *
+         * @code
+         * constexpr vec4 position(vec3(1.0f, 2.0f, 3.0f), 1.0f);
+         * @endcode
          */
-        template<typename... Args>
-        Vecf(const Args&... args)
+        template<typename... Args, typename = typename std::enable_if<!_vec_detail::narrowing<N, Args...>::value>::type>
+        constexpr Vecf(const Args&... args)
+            : Vecf(typename _vec_detail::construction<N, Args...>::type(), args...)
+        {
+            
+        }
+        /**
+         * @brief Construct a Vecf from the first values of a bigger one, which only happens explicitly.
+         * @param[in] other The bigger Vecf, its last values being dropped.
+         *
+         * @code
+         * vec4 position(1.0f, 2.0f, 3.0f, 1.0f);
+         * vec3 a(position);        // { 1 2 3 }, as position.xyz().
+         * vec3 b = position;       // Doesn't compile, like b = position.
+         * @endcode
+         */
+        template<typename V, typename = typename std::enable_if<_vec_detail::narrowing<N, V>::value>::type, typename = void>
+        explicit constexpr Vecf(const V& other)
+            : Vecf(typename _meta::make_indices<N>::type(), other)
         {
-            this->_construct(0, args...);
+            
         }
         /**
          * @brief Convert this Vecf into a pointer to float, for a const Vecf.
@@ -52,52 +722,62 @@ struct Vecf final
          * @brief Returns the x coordinate value of this vec.
          * @return The x value as a float.
          */
-        T x(void) const {return this->values[0];}
+        constexpr T x(void) const {return this->values[0];}
         /**
          * @brief Returns the y coordinate value of this vec.
          * @return The y value as a float.
          */
-        T y(void) const {return this->values[1];}
+        constexpr T y(void) const {return this->values[1];}
         /**
          * @brief Returns the u texcoord value of this vec2.
          * @return The u value of this vec2 as a float.
          */
-        T u(void) const {return this->x();}
+        constexpr T u(void) const {return this->x();}
         /**
          * @brief Returns the v texcoord value of this vec2.
          * @return The v value of this vec2 as a float.
          */
-        T v(void) const {return this->z();}
+        constexpr T v(void) const {return this->y();}
         /**
          * @brief Returns the z coordinate value of this vecX with X >= 3
          * @return This z value as a float.
+         * @pre this must represent a vec3 or vec4, checked at compile time.
          */
-        T z(void) const {return this->_request_z(std::integral_constant<bool, N >= 3>());}
+        constexpr T z(void) const
+        {
+            static_assert(N >= 3, "Request for z|b with vec2 is invalid !");
+            return this->values[2];
+        }
         /**
          * @brief Returns the homogenic coordinate value of this vec4
          * @return This w value as a float.
+         * @pre this must represent a vec4, checked at compile time.
          */
-        T w(void) const {return this->_request_w(std::integral_constant<bool, N == 4>());}
+        constexpr T w(void) const
+        {
+            static_assert(N == 4, "Request for w|a with vec2|3 is invalid !");
+            return this->values[3];
+        }
         /**
          * @brief Returns the alpha value of this vec4
          * @return This a value as a float.
          */
-        T a(void) const {return this->w();}
+        constexpr T a(void) const {return this->w();}
         /**
          * @brief Returns the r red value of this vec3|4
          * @return This r value as a float.
          */
-        T r(void) const {return this->x();}
+        constexpr T r(void) const {return this->x();}
         /**
          * @brief Returns the g green value of this vec3|4
          * @return This g value as a float.
          */
-        T g(void) const {return this->y();}
+        constexpr T g(void) const {return this->y();}
         /**
          * @brief Returns the b blue value of this vec3|4
          * @return This b value as a float.
          */
-        T b(void) const {return this->z();}
+        constexpr T b(void) const {return this->z();}
         /**
          * @brief Sets the x coordinate value to \b value.
          * @param[in] value The new value to set up.
@@ -113,7 +793,11 @@ struct Vecf final
          * @param[in] value The new value to set up.
          * @pre this must represent a vec3 or vec4.
          */
-        void z(T value) {this->_set_z(value, std::integral_constant<bool, N >= 3>());}
+        void z(T value)
+        {
+            static_assert(N >= 3, "Request for z|b with vec2 is invalid !");
+            this->values[2] = value;
+        }
         /**
          * @brief Sets the u texcoord value to \b value.
          * @param[in] value The new value to set up.
@@ -137,7 +821,11 @@ struct Vecf final
          * @param[in] value The new value to set up.
          * @pre this must represent a vec4.
          */
-        void w(T value) {this->_set_w(value, std::integral_constant<bool, N == 4>());}
+        void w(T value)
+        {
+            static_assert(N == 4, "Request for w|a with vec2|3 is invalid !");
+            this->values[3] = value;
+        }
         /**
          * @brief Sets the red color value to \b value.
          * @param[in] value The new value to set up.
@@ -157,45 +845,60 @@ struct Vecf final
          */
         void b(T value) {this->z(value);}
         /**
-         * @brief Affects \b other to \b this as a copy.
-         * @param[in] other The same Vecf to copy.
-         * @return A reference into \b this to chain calls.
+         * @brief Returns the value of the lane \b I (0 for x, 1 for y...).
+         * @return This value.
+         * @pre \b I must be lower than N, checked at compile time.
          */
-        Vecf<T, N>& operator=(const Vecf<T, N>& other) noexcept
+        template<uint32_t I>
+        constexpr T lane(void) const
         {
-            this->copy(other);
-            return *this;
+            static_assert(I < N, "Requested lane is out of this Vecf");
+            return this->values[I];
         }
         /**
-         * @brief Moves \b other to \b this as a copy.
-         * @param[in] other The same Vecf to copy.
-         * @return A reference into \b this to chain calls.
+         * @brief Builds a new Vecf from the lanes \b L of this one, GLSL style.
+         * Every named swizzle (xy(), zyx(), xxyy(), bgra()...) forwards here.
+         * @return A Vecf<T, sizeof...(L)> made of the requested values.
+         * @pre Every lane must be lower than N, checked at compile time.
+         *
+         * @code
+         * vec4 v(1.0f, 2.0f, 3.0f, 4.0f);
+         * vec3 a = v.swizzle<2, 1, 0>(); // { 3 2 1 }
+         * vec4 b = v.bgra();             // { 3 2 1 4 }
+         * vec2 c = a.zw();               // Doesn't compile, a is a vec3.
+         * @endcode
          */
-        Vecf<T, N>& operator=(Vecf<T, N>&& other) noexcept
+        template<uint32_t... L>
+        constexpr Vecf<T, sizeof...(L)> swizzle(void) const
         {
-            this->copy(other);
-            return *this;
+            static_assert(_vec_detail::all_lower<N, L...>::value, "Requested lane is out of this Vecf");
+            return _vec_kernel::swizzle<T, N, L...>::apply(*this);
         }
+        
+        //! @cond SKIP_THIS_DOXYGEN
+        MTLKIT_VEC_SWIZZLES(x, y, z, w)
+        MTLKIT_VEC_SWIZZLES(r, g, b, a)
+        //! @endcond
+        
+        Vecf<T, N>& operator=(const Vecf<T, N>& other) = default;
+        Vecf<T, N>& operator=(Vecf<T, N>&& other)      = default;
         /**
-         * @brief Affects \b other to \b this as a copy.
+         * @brief Affects a smaller Vecf \b other to the first lanes of \b this, the others are kept.
+         * Assigning a bigger Vecf doesn't compile : narrow it explicitly with a swizzle (xyz()...).
          * @param[in] other Another type of Vecf to copy.
          * @return A reference into \b this to chain calls.
+         *
+         * @code
+         * vec4 position(0.0f, 0.0f, 0.0f, 1.0f);
+         * position = vec3(1.0f, 2.0f, 3.0f); // { 1 2 3 1 }
+         * vec3 v = position.xyz();           // v = position doesn't compile.
+         * @endcode
          */
         template<uint32_t V>
         Vecf<T, N>& operator=(const Vecf<T, V>& other) noexcept
         {
-            this->copy(other);
-            return *this;
-        }
-        /**
-         * @brief Moves \b other to \b this as a copy.
-         * @param[in] other Another type of Vecf to copy.
-         * @return A reference into \b this to chain calls.
-         */
-        template<uint32_t V>
-        Vecf<T, N>& operator=(Vecf<T, V>&& other) noexcept
-        {
-            this->copy(other);
+            static_assert(V < N, "Assigning a bigger Vecf would truncate it, use a swizzle such as xyz() instead");
+            this->_assign(other, typename _meta::make_indices<V>::type());
             return *this;
         }
         
@@ -207,82 +910,61 @@ struct Vecf final
         static_assert(N >= 2 && N <= 4, "N of Vecf must be between 2 and 4 included");
         static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic datatype");
         
-        /**
-         * @brief Copy X elements from \b other to \b this, with X = min(#other, #this)
-         * @param[in] other The Vecf to copy into this.
-         * @return The number of copied elements.
-         */
-        template<uint32_t V>
-        uint32_t copy(const Vecf<T, V>& other)
+        //! @brief Copies the lanes \b I of \b other, unrolled at compile time.
+        template<uint32_t V, uint32_t... I>
+        void _assign(const Vecf<T, V>& other, _meta::indices<I...>) noexcept
         {
-            uint32_t max_iteration = std::min(V, N);
-            uint32_t n             = 0;
-            for(uint32_t i=0;i<max_iteration;++i)
-            {
-                this->values[i] = other.values[i];
-                ++n;
-            }
-            return n;
+            const int unroll[] = {(this->values[I] = other.values[I], 0)...};
+            (void)unroll;
         }
-        //! @brief Construct by copying from a Vecf
-        template<uint32_t V, typename... Args>
-        void _construct(uint32_t n, const Vecf<T, V>& other, const Args&... args)
+        //! @brief Construct from at most N numerics, the remaining values are T().
+        template<typename... Args>
+        constexpr Vecf(_vec_detail::flat, const Args&... args) : values{static_cast<T>(args)...}
         {
-            n += this->copy(other);
-            this->_construct(n, args...);
+            
         }
-        //! @brief If you provides too few values.
-        void _construct(uint32_t n)
+        //! @brief Construct from anything else, each value I is fetched across \b args.
+        template<uint32_t... I, typename... Args>
+        constexpr Vecf(_meta::indices<I...>, const Args&... args) : values{Vecf<T, N>::_fetch(I, args...)...}
         {
-            if (n < N)
-            {
-                this->values[n] = T();
-                this->_construct(n+1);
-            }
+            
         }
-        //! @brief Terminal case.
-        void _construct(void){}
-        //! @brief Filling up the floats.
-        template<typename Data, typename... Args>
-        void _construct(uint32_t n, const Data& f, const Args&... args)
+        //! @brief Gets the value \b i of a Vecf argument.
+        template<uint32_t V>
+        static constexpr T _component(const Vecf<T, V>& other, uint32_t i)
         {
-            static_assert(std::is_arithmetic<Data>::value, "Arguments must be vec or numerics !");
-            if (n < N)
-            {
-                this->values[n] = static_cast<T>(f);
-                this->_construct(n+1, args...);
-            }
+            return other.values[i];
         }
-        T _request_z(std::true_type)  const {return this->values[2];}
-        T _request_z(std::false_type) const {
-            throw std::out_of_range("Request for z|b with vec2 is invalid !");
-            return 0.0f;
+        //! @brief Gets the value \b i of an AlignedVecf argument.
+        template<uint32_t V, std::size_t A>
+        static constexpr T _component(const AlignedVecf<T, V, A>& other, uint32_t i)
+        {
+            return Vecf<T, N>::_component(static_cast<const Vecf<T, V>&>(other), i);
         }
-        T _request_w(std::true_type)  const {return this->values[3];}
-        T _request_w(std::false_type) const {
-            throw std::out_of_range("Request for w|a with vec2|3 is invalid !");
-            return 0.0f;
+        //! @brief Gets the value of a numeric argument.
+        template<typename Data>
+        static constexpr T _component(const Data& f, uint32_t)
+        {
+            static_assert(std::is_arithmetic<Data>::value, "Arguments must be vec or numerics !");
+            return static_cast<T>(f);
         }
-        void _set_w(T value, std::true_type)  {this->values[3] = value;}
-        void _set_w(T value, std::false_type) {
-            (void)value;
-            throw std::out_of_range("Request for w|a with vec2|3 is invalid !");
+        //! @brief If you provides too few values.
+        static constexpr T _fetch(uint32_t)
+        {
+            return T();
         }
-        void _set_z(T value, std::true_type)  {this->values[2] = value;}
-        void _set_z(T value, std::false_type) {
-            (void)value;
-            throw std::out_of_range("Request for z|b with vec2 is invalid !");
+        //! @brief Gets the value \b i among every values brought by the arguments.
+        template<typename Data, typename... Args>
+        static constexpr T _fetch(uint32_t i, const Data& first, const Args&... args)
+        {
+            return (i < _vec_detail::arity<Data>::value) ? Vecf<T, N>::_component(first, i)
+                 : Vecf<T, N>::_fetch(i - _vec_detail::arity<Data>::value, args...);
         }
         
         template<typename TT, uint32_t V> friend Vecf<TT, V>   operator+ (const Vecf<TT, V>& v1, const Vecf<TT, V>& v2);
         template<typename TT, uint32_t V> friend Vecf<TT, V>   operator- (const Vecf<TT, V>& v1, const Vecf<TT, V>& v2);
-        template<typename TT, uint32_t V> friend Vecf<TT, V>   operator* (const Vecf<TT, V>& v, float f);
-        template<typename TT, uint32_t V> friend Vecf<TT, V>   operator* (float f, const Vecf<TT, V>& v);
-        template<typename TT, uint32_t V> friend Vecf<TT, V>   operator/ (const Vecf<TT, V>& v, float f);
         template<typename TT, uint32_t V> friend Vecf<TT, V>&  operator+=(Vecf<TT, V>& self, const Vecf<TT, V>& other);
         template<typename TT, uint32_t V> friend Vecf<TT, V>&  operator-=(Vecf<TT, V>& self, const Vecf<TT, V>& other);
-        template<typename TT, uint32_t V> friend Vecf<TT, V>&  operator*=(Vecf<TT, V>& self, float f);
-        template<typename TT, uint32_t V> friend Vecf<TT, V>&  operator/=(Vecf<TT, V>& self, float f);
         template<typename TT, uint32_t V> friend bool          operator==(const Vecf<TT, V>& v1, const Vecf<TT, V>& v2);
         template<typename TT, uint32_t V> friend bool          operator!=(const Vecf<TT, V>& v1, const Vecf<TT, V>& v2);
         template<typename TT, uint32_t V> friend std::ostream& operator<<(std::ostream& os, const Vecf<TT, V>& v);
@@ -291,6 +973,24 @@ struct Vecf final
         friend struct Vecf<T, 4>;
 };
 
+//! @cond SKIP_THIS_DOXYGEN
+#undef MTLKIT_VEC_SWIZZLES
+#undef MTLKIT_VEC_SWIZZLES_2
+#undef MTLKIT_VEC_SWIZZLES_3
+#undef MTLKIT_VEC_SWIZZLES_4
+#undef MTLKIT_VEC_SWIZZLE4
+#undef MTLKIT_VEC_SWIZZLE3
+#undef MTLKIT_VEC_SWIZZLE2
+#undef MTLKIT_VEC_LANE_x
+#undef MTLKIT_VEC_LANE_y
+#undef MTLKIT_VEC_LANE_z
+#undef MTLKIT_VEC_LANE_w
+#undef MTLKIT_VEC_LANE_r
+#undef MTLKIT_VEC_LANE_g
+#undef MTLKIT_VEC_LANE_b
+#undef MTLKIT_VEC_LANE_a
+//! @endcond
+
 
 /**
  * @brief Apply the + operator on 2 Vecf and write the result into
@@ -303,10 +1003,7 @@ template<typename T, uint32_t N>
 Vecf<T, N> operator+(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
 {
     Vecf<T, N> result;
-    for(uint32_t i=0;i<N;++i)
-    {
-        result.values[i] = v1.values[i] + v2.values[i];
-    }
+    _vec_kernel::kernel<T, N>::add(v1.values, v2.values, result.values);
     return result;
 }
 /**
@@ -320,53 +1017,44 @@ template<typename T, uint32_t N>
 Vecf<T, N> operator-(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
 {
     Vecf<T, N> result;
-    for(uint32_t i=0;i<N;++i)
-    {
-        result.values[i] = v1.values[i] - v2.values[i];
-    }
+    _vec_kernel::kernel<T, N>::sub(v1.values, v2.values, result.values);
     return result;
 }
 /**
  * @brief Apply the operator * between \b v and \b f.
  * @param[in] v The Vecf to operate with.
- * @param[in] f The value to multiply.
+ * @param[in] f The value to multiply, converted to T (an integer Vecf refuses floating points).
  * @return A copy of the result as a Vecf.
  */
-template<typename T, uint32_t N>
-Vecf<T, N> operator*(const Vecf<T, N>& v, float f)
+template<typename T, uint32_t N, typename S>
+typename _vec_detail::scalar_result<T, N, S>::type operator*(const Vecf<T, N>& v, S f)
 {
     Vecf<T, N> result;
-    for(uint32_t i=0;i<N;++i)
-    {
-        result.values[i] = v.values[i] * f;
-    }
+    _vec_kernel::kernel<T, N>::scale(v, static_cast<T>(f), result);
     return result;
 }
 /**
  * @brief Apply the other case of the operator *, with commutativity.
- * @param[in] f The value to multiply.
+ * @param[in] f The value to multiply, converted to T (an integer Vecf refuses floating points).
  * @param[in] v The Vecf to operate with.
  * @return A copy of the result as a Vecf.
  */
-template<typename T, uint32_t N>
-Vecf<T, N> operator*(float f, const Vecf<T, N>& v)
+template<typename T, uint32_t N, typename S>
+typename _vec_detail::scalar_result<T, N, S>::type operator*(S f, const Vecf<T, N>& v)
 {
     return v*f;
 }
 /**
- * @brief Apply the operator / between \b v and \b f.
+ * @brief Apply the operator / between \b v and \b f, an integer division for an integer Vecf.
  * @param[in] v The Vecf to operate with.
- * @param[in] f The value to divide with.
+ * @param[in] f The value to divide with, converted to T (an integer Vecf refuses floating points).
  * @return A copy of the result as a Vecf.
  */
-template<typename T, uint32_t N>
-Vecf<T, N> operator/(const Vecf<T, N>& v, float f)
+template<typename T, uint32_t N, typename S>
+typename _vec_detail::scalar_result<T, N, S>::type operator/(const Vecf<T, N>& v, S f)
 {
     Vecf<T, N> result;
-    for(uint32_t i=0;i<N;++i)
-    {
-        result.values[i] = v.values[i] / f;
-    }
+    _vec_kernel::kernel<T, N>::divide(v, static_cast<T>(f), result);
     return result;
 }
 /**
@@ -378,10 +1066,7 @@ Vecf<T, N> operator/(const Vecf<T, N>& v, float f)
 template<typename T, uint32_t N>
 Vecf<T, N>& operator+=(Vecf<T, N>& self, const Vecf<T, N>& other)
 {
-    for(uint32_t i=0;i<N;++i)
-    {
-        self.values[i] += other.values[i];
-    }
+    _vec_kernel::kernel<T, N>::add(self.values, other.values, self.values);
     return self;
 }
 /**
@@ -393,40 +1078,31 @@ Vecf<T, N>& operator+=(Vecf<T, N>& self, const Vecf<T, N>& other)
 template<typename T, uint32_t N>
 Vecf<T, N>& operator-=(Vecf<T, N>& self, const Vecf<T, N>& other)
 {
-    for(uint32_t i=0;i<N;++i)
-    {
-        self.values[i] -= other.values[i];
-    }
+    _vec_kernel::kernel<T, N>::sub(self.values, other.values, self.values);
     return self;
 }
 /**
  * @brief Multiply \b self by \b f by modifying \b self' content.
  * @param[in,out] self The Vecf to modify.
- * @param[in]     f The value to multiply with.
+ * @param[in]     f The value to multiply with, converted to T.
  * @return A reference to \b self for further operations.
  */
-template<typename T, uint32_t N>
-Vecf<T, N>& operator*=(Vecf<T, N>& self, float f)
+template<typename T, uint32_t N, typename S>
+typename _vec_detail::scalar_result<T, N, S>::type& operator*=(Vecf<T, N>& self, S f)
 {
-    for(uint32_t i=0;i<N;++i)
-    {
-        self.values[i] *= f;
-    }
+    _vec_kernel::kernel<T, N>::scale(self, static_cast<T>(f), self);
     return self;
 }
 /**
  * @brief Divide \b self by \b f by modifying \b self' content.
  * @param[in,out] self The Vecf to modify.
- * @param[in]     f The value to divide with.
+ * @param[in]     f The value to divide with, converted to T.
  * @return A reference to \b self for further operations.
  */
-template<typename T, uint32_t N>
-Vecf<T, N>& operator/=(Vecf<T, N>& self, float f)
+template<typename T, uint32_t N, typename S>
+typename _vec_detail::scalar_result<T, N, S>::type& operator/=(Vecf<T, N>& self, S f)
 {
-    for(uint32_t i=0;i<N;++i)
-    {
-        self.values[i] /= f;
-    }
+    _vec_kernel::kernel<T, N>::divide(self, static_cast<T>(f), self);
     return self;
 }
 /**
@@ -438,15 +1114,7 @@ Vecf<T, N>& operator/=(Vecf<T, N>& self, float f)
 template<typename T, uint32_t N>
 bool operator==(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
 {
-    const float EPSILON = 0.0001;
-    for(uint32_t i=0;i<N;++i)
-    {
-        if (std::abs(v1.values[i] - v2.values[i]) > EPSILON)
-        {
-            return false;
-        }
-    }
-    return true;
+    return _vec_kernel::kernel<T, N>::equal(v1.values, v2.values);
 }
 /**
  * @brief Compare the values of \b v1 and \b v2 for inequality.
@@ -459,6 +1127,147 @@ bool operator!=(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
 {
     return !(v1 == v2);
 }
+/**
+ * @brief Computes the bitwise and of \b v1 and \b v2, for integer Vecf.
+ * @param[in] v1 The first  Vecf.
+ * @param[in] v2 The second Vecf.
+ * @return A new Vecf with v1[i] & v2[i].
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> operator&(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
+{
+    static_assert(std::is_integral<T>::value, "Bitwise operators require an integer Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::bitAnd(v1, v2, result);
+    return result;
+}
+/**
+ * @brief Computes the bitwise or of \b v1 and \b v2, for integer Vecf.
+ * @param[in] v1 The first  Vecf.
+ * @param[in] v2 The second Vecf.
+ * @return A new Vecf with v1[i] | v2[i].
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> operator|(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
+{
+    static_assert(std::is_integral<T>::value, "Bitwise operators require an integer Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::bitOr(v1, v2, result);
+    return result;
+}
+/**
+ * @brief Computes the bitwise exclusive or of \b v1 and \b v2, for integer Vecf.
+ * @param[in] v1 The first  Vecf.
+ * @param[in] v2 The second Vecf.
+ * @return A new Vecf with v1[i] ^ v2[i].
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> operator^(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
+{
+    static_assert(std::is_integral<T>::value, "Bitwise operators require an integer Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::bitXor(v1, v2, result);
+    return result;
+}
+/**
+ * @brief Computes the bitwise complement of \b v, for integer Vecf.
+ * @param[in] v The Vecf to complement.
+ * @return A new Vecf with ~v[i].
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> operator~(const Vecf<T, N>& v)
+{
+    static_assert(std::is_integral<T>::value, "Bitwise operators require an integer Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::bitNot(v, result);
+    return result;
+}
+/**
+ * @brief Shifts every lane of \b v to the left, for integer Vecf.
+ * @param[in] v The Vecf to shift.
+ * @param[in] n The number of bits.
+ * @return A new Vecf with v[i] << n.
+ * @pre \b n must be lower than the number of bits of T.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> operator<<(const Vecf<T, N>& v, uint32_t n)
+{
+    static_assert(std::is_integral<T>::value, "Bitwise operators require an integer Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::shiftLeft(v, n, result);
+    return result;
+}
+/**
+ * @brief Shifts every lane of \b v to the right, for integer Vecf.
+ * It is an arithmetic shift for ivec (the sign is kept), a logical one for uvec.
+ * @param[in] v The Vecf to shift.
+ * @param[in] n The number of bits.
+ * @return A new Vecf with v[i] >> n.
+ * @pre \b n must be lower than the number of bits of T.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> operator>>(const Vecf<T, N>& v, uint32_t n)
+{
+    static_assert(std::is_integral<T>::value, "Bitwise operators require an integer Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::shiftRight(v, n, result);
+    return result;
+}
+/**
+ * @brief Apply \b self & \b other , by modifying \b self.
+ * @param[in,out] self  The Vecf to modify.
+ * @param[in]     other The other Vecf for the operation.
+ * @return A reference to \b self for further operations.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N>& operator&=(Vecf<T, N>& self, const Vecf<T, N>& other)
+{
+    return self = self & other;
+}
+/**
+ * @brief Apply \b self | \b other , by modifying \b self.
+ * @param[in,out] self  The Vecf to modify.
+ * @param[in]     other The other Vecf for the operation.
+ * @return A reference to \b self for further operations.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N>& operator|=(Vecf<T, N>& self, const Vecf<T, N>& other)
+{
+    return self = self | other;
+}
+/**
+ * @brief Apply \b self ^ \b other , by modifying \b self.
+ * @param[in,out] self  The Vecf to modify.
+ * @param[in]     other The other Vecf for the operation.
+ * @return A reference to \b self for further operations.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N>& operator^=(Vecf<T, N>& self, const Vecf<T, N>& other)
+{
+    return self = self ^ other;
+}
+/**
+ * @brief Shifts \b self to the left by \b n bits.
+ * @param[in,out] self The Vecf to modify.
+ * @param[in]     n    The number of bits.
+ * @return A reference to \b self for further operations.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N>& operator<<=(Vecf<T, N>& self, uint32_t n)
+{
+    return self = self << n;
+}
+/**
+ * @brief Shifts \b self to the right by \b n bits.
+ * @param[in,out] self The Vecf to modify.
+ * @param[in]     n    The number of bits.
+ * @return A reference to \b self for further operations.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N>& operator>>=(Vecf<T, N>& self, uint32_t n)
+{
+    return self = self >> n;
+}
 /**
  * @brief Display the content of \b v into \b os.
  * It doesn't display a newline.
@@ -478,6 +1287,190 @@ std::ostream& operator<<(std::ostream& os, const Vecf<TT, V>& v)
     return os;
 }
 
+/**
+ * @brief Computes the dot product of \b v1 and \b v2.
+ * @param[in] v1 The first  Vecf.
+ * @param[in] v2 The second Vecf.
+ * @return The sum of the products of each lane.
+ */
+template<typename T, uint32_t N>
+T dot(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
+{
+    return _vec_kernel::kernel<T, N>::dot(v1, v2);
+}
+/**
+ * @brief Computes the cross product of \b v1 and \b v2.
+ * @param[in] v1 The first  vec3.
+ * @param[in] v2 The second vec3.
+ * @return A new Vecf orthogonal to \b v1 and \b v2.
+ */
+template<typename T>
+Vecf<T, 3> cross(const Vecf<T, 3>& v1, const Vecf<T, 3>& v2)
+{
+    Vecf<T, 3> result;
+    _vec_kernel::kernel<T, 3>::cross(v1, v2, result);
+    return result;
+}
+/**
+ * @brief Computes the squared length of \b v, which avoids a square root for comparisons.
+ * @param[in] v The Vecf to measure.
+ * @return dot(v, v).
+ */
+template<typename T, uint32_t N>
+T squaredLength(const Vecf<T, N>& v)
+{
+    return dot(v, v);
+}
+/**
+ * @brief Computes the length of \b v.
+ * @param[in] v The Vecf to measure.
+ * @return The euclidean norm of \b v.
+ */
+template<typename T, uint32_t N>
+T length(const Vecf<T, N>& v)
+{
+    static_assert(std::is_floating_point<T>::value, "length requires a floating point Vecf");
+    return std::sqrt(dot(v, v));
+}
+/**
+ * @brief Computes an approximation of the length of \b v, with a relative error below 1e-6 for vec3|4.
+ * @details It uses the approximated reciprocal square root and one Newton-Raphson step
+ * instead of a square root, if the SIMD path is enabled. Otherwise it's length().
+ * @param[in] v The Vecf to measure.
+ * @return The approximated euclidean norm of \b v.
+ */
+template<typename T, uint32_t N>
+T fastLength(const Vecf<T, N>& v)
+{
+    static_assert(std::is_floating_point<T>::value, "fastLength requires a floating point Vecf");
+    return _vec_kernel::kernel<T, N>::fastLength(v);
+}
+/**
+ * @brief Computes the distance between \b v1 and \b v2.
+ * @param[in] v1 The first  point.
+ * @param[in] v2 The second point.
+ * @return The length of \b v2 - \b v1.
+ */
+template<typename T, uint32_t N>
+T distance(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
+{
+    return length(v2 - v1);
+}
+/**
+ * @brief Scales \b v to a length of 1.
+ * @param[in] v The Vecf to normalize.
+ * @return A new Vecf with the same direction as \b v.
+ * @pre \b v must not be a null vector.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> normalize(const Vecf<T, N>& v)
+{
+    static_assert(std::is_floating_point<T>::value, "normalize requires a floating point Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::normalize(v, result);
+    return result;
+}
+/**
+ * @brief Scales \b v to a length of approximately 1, see fastLength() for the precision.
+ * @param[in] v The Vecf to normalize.
+ * @return A new Vecf with the same direction as \b v.
+ * @pre \b v must not be a null vector.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> fastNormalize(const Vecf<T, N>& v)
+{
+    static_assert(std::is_floating_point<T>::value, "fastNormalize requires a floating point Vecf");
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::fastNormalize(v, result);
+    return result;
+}
+/**
+ * @brief Linear interpolation between \b v1 and \b v2.
+ * @param[in] v1 The value for \b t = 0.
+ * @param[in] v2 The value for \b t = 1.
+ * @param[in] t  The interpolation factor.
+ * @return v1 + (v2 - v1) * t.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> lerp(const Vecf<T, N>& v1, const Vecf<T, N>& v2, float t)
+{
+    return v1 + (v2 - v1) * t;
+}
+/**
+ * @brief Computes the reflection direction of the incident \b i about the normal \b n, like GLSL reflect.
+ * @param[in] i The incident vector.
+ * @param[in] n The normal, which must be normalized.
+ * @return i - 2 * dot(n, i) * n.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> reflect(const Vecf<T, N>& i, const Vecf<T, N>& n)
+{
+    return i - n * (2 * dot(n, i));
+}
+
+/**
+ * @brief Computes the componentwise minimum of \b v1 and \b v2.
+ * @param[in] v1 The first  Vecf.
+ * @param[in] v2 The second Vecf.
+ * @return A new Vecf with the lowest value of each lane.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> min(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
+{
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::min(v1, v2, result);
+    return result;
+}
+/**
+ * @brief Computes the componentwise maximum of \b v1 and \b v2.
+ * @param[in] v1 The first  Vecf.
+ * @param[in] v2 The second Vecf.
+ * @return A new Vecf with the highest value of each lane.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> max(const Vecf<T, N>& v1, const Vecf<T, N>& v2)
+{
+    Vecf<T, N> result;
+    _vec_kernel::kernel<T, N>::max(v1, v2, result);
+    return result;
+}
+/**
+ * @brief Constrains every lane of \b v between the ones of \b low and \b high, like GLSL clamp.
+ * @param[in] v    The Vecf to clamp.
+ * @param[in] low  The lowest  values allowed.
+ * @param[in] high The highest values allowed.
+ * @return min(max(v, low), high).
+ * @pre \b low must not be greater than \b high.
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> clamp(const Vecf<T, N>& v, const Vecf<T, N>& low, const Vecf<T, N>& high)
+{
+    return min(max(v, low), high);
+}
+/**
+ * @brief Constrains every lane of \b v between \b low and \b high.
+ * @param[in] v    The Vecf to clamp.
+ * @param[in] low  The lowest  value allowed.
+ * @param[in] high The highest value allowed.
+ * @return min(max(v, low), high).
+ * @pre \b low must not be greater than \b high.
+ *
+ * @code
+ * ivec3 cell = clamp(voxel >> 4, 0, GRID_SIZE - 1);
+ * @endcode
+ */
+template<typename T, uint32_t N>
+Vecf<T, N> clamp(const Vecf<T, N>& v, typename std::common_type<T>::type low, typename std::common_type<T>::type high)
+{
+    Vecf<T, N> lows, highs;
+    for(uint32_t i=0;i<N;++i)
+    {
+        lows[i]  = low;
+        highs[i] = high;
+    }
+    return clamp(v, lows, highs);
+}
+
 typedef Vecf<float,    2>  vec2; //!< To manipulate a  float  vec2.
 typedef Vecf<float,    3>  vec3; //!< To manipulate a  float  vec3.
 typedef Vecf<float,    4>  vec4; //!< To manipulate a  float  vec4.
@@ -496,4 +1489,64 @@ typedef vec3    Vertex;    //!< To manipulate something more clear than a vec3.
 typedef vec3    Normal;    //!< To manipulate something more clear than a vec3.
 typedef vec4    Color;     //!< To manipulate something more clear than a vec4.
 
+static_assert(std::is_trivially_copyable<vec3>::value, "vec3 must stay memcpy-able");
+static_assert(std::is_trivially_copyable<vec4>::value, "vec4 must stay memcpy-able");
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _vec_detail
+{
+    /*
+     * The smallest power of two holding the whole vector : vec3/vec4 -> 16, dvec3/dvec4 -> 32.
+     */
+    constexpr std::size_t alignment(std::size_t bytes, std::size_t power = 1)
+    {
+        return (power >= bytes) ? power : alignment(bytes, power * 2);
+    }
+}
+//! @endcond
+
+/**
+ * @struct AlignedVecf
+ * @brief An opt-in Vecf aligned on \b A bytes, so it never straddles two cache lines.
+ * @details By default \b A is the size of the vector rounded up to a power of two, so an avec3 is
+ * padded to 16 bytes. It is used as any Vecf (operators, functions...) ; containers of them need an
+ * AlignedAllocator (see aligned.hpp) to keep the alignment before C++17.
+ *
+ * @code
+ * AlignedVector<avec4> positions(count); // positions.data() can be loaded with _mm_load_ps.
+ * positions[0] = avec4(vec3(1.0f, 2.0f, 3.0f), 1.0f);
+ * @endcode
+ */
+template<typename T, uint32_t N, std::size_t A = _vec_detail::alignment(N * sizeof(T))>
+struct alignas(A) AlignedVecf : public Vecf<T, N>
+{
+    public:
+        /**
+         * @brief Construct an AlignedVecf as any Vecf, with numerics and/or Vecf, GLSL style.
+         * @param[in] args Every arguments being passed to the Vecf constructor.
+         */
+        template<typename... Args, typename = typename std::enable_if<!_vec_detail::narrowing<N, Args...>::value>::type>
+        constexpr AlignedVecf(const Args&... args) : Vecf<T, N>(args...)
+        {
+
+        }
+        /**
+         * @brief Construct an AlignedVecf from the first values of a bigger Vecf, explicitly as a Vecf.
+         * @param[in] other The bigger Vecf, its last values being dropped.
+         */
+        template<typename V, typename = typename std::enable_if<_vec_detail::narrowing<N, V>::value>::type, typename = void>
+        explicit constexpr AlignedVecf(const V& other) : Vecf<T, N>(other)
+        {
+
+        }
+};
+
+typedef AlignedVecf<float,  3>  avec3; //!< To manipulate a  float  vec3 padded to 16 bytes.
+typedef AlignedVecf<float,  4>  avec4; //!< To manipulate a  float  vec4 aligned on 16 bytes.
+typedef AlignedVecf<double, 4> advec4; //!< To manipulate a  double vec4 aligned on 32 bytes.
+
+static_assert(sizeof(avec3) == 16 && alignof(avec3) == 16, "avec3 must fill exactly 16 bytes");
+static_assert(std::is_trivially_copyable<avec4>::value, "avec4 must stay memcpy-able");
+
 #endif
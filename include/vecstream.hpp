@@ -0,0 +1,713 @@
+/**
+ * @file vecstream.hpp
+ * @brief Defines structure of arrays containers for Vecf, and the batched kernels working on them.
+ *
+ * A VecStream stores every x, every y, every z... in separated lanes, so the kernels below
+ * process 8 to 16 vectors per iteration with the widest registers available (see simd.hpp).
+ * @author MTLCRBN
+ * @version 1.0
+ */
+#ifndef MTLKIT_VECSTREAM_HPP_INCLUDED
+#define MTLKIT_VECSTREAM_HPP_INCLUDED
+
+#include <cmath>     // For std::sqrt
+#include <cstddef>   // For std::size_t
+#include <cstdint>   // For fixed bytes sized types.
+#include <stdexcept> // For std::invalid_argument
+#include <vector>    // For std::vector
+
+#include "aligned.hpp"
+#include "simd.hpp"
+#include "vec.hpp"
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _vec_stream // Do not try to use that.
+{
+    /*
+     * One lane at a time, every type ends up here for the remaining elements of a stream.
+     * loada/storea need an address aligned on the pack width, as in the lanes of a VecStream.
+     */
+    template<typename T>
+    struct scalar
+    {
+        typedef T type;
+        static const std::size_t WIDTH = 1;
+        static type load(const T* p)          noexcept {return *p;}
+        static void store(T* p, type v)       noexcept {*p = v;}
+        static type loada(const T* p)         noexcept {return *p;}
+        static void storea(T* p, type v)      noexcept {*p = v;}
+        static type set1(T v)                 noexcept {return v;}
+        static type add(type a, type b)       noexcept {return a + b;}
+        static type sub(type a, type b)       noexcept {return a - b;}
+        static type mul(type a, type b)       noexcept {return a * b;}
+        static type div(type a, type b)       noexcept {return a / b;}
+        static type sqrt(type a)              noexcept {return static_cast<T>(std::sqrt(a));}
+    };
+    /*
+     * The widest registers available for T, scalar by default.
+     */
+    template<typename T>
+    struct wide : public scalar<T> {};
+#if defined(MTLKIT_SIMD_AVX)
+    template<>
+    struct wide<float>
+    {
+        typedef __m256 type;
+        static const std::size_t WIDTH = 8;
+        static type load(const float* p)      noexcept {return _mm256_loadu_ps(p);}
+        static void store(float* p, type v)   noexcept {_mm256_storeu_ps(p, v);}
+        static type loada(const float* p)     noexcept {return _mm256_load_ps(p);}
+        static void storea(float* p, type v)  noexcept {_mm256_store_ps(p, v);}
+        static type set1(float v)             noexcept {return _mm256_set1_ps(v);}
+        static type add(type a, type b)       noexcept {return _mm256_add_ps(a, b);}
+        static type sub(type a, type b)       noexcept {return _mm256_sub_ps(a, b);}
+        static type mul(type a, type b)       noexcept {return _mm256_mul_ps(a, b);}
+        static type div(type a, type b)       noexcept {return _mm256_div_ps(a, b);}
+        static type sqrt(type a)              noexcept {return _mm256_sqrt_ps(a);}
+    };
+    template<>
+    struct wide<double>
+    {
+        typedef __m256d type;
+        static const std::size_t WIDTH = 4;
+        static type load(const double* p)     noexcept {return _mm256_loadu_pd(p);}
+        static void store(double* p, type v)  noexcept {_mm256_storeu_pd(p, v);}
+        static type loada(const double* p)    noexcept {return _mm256_load_pd(p);}
+        static void storea(double* p, type v) noexcept {_mm256_store_pd(p, v);}
+        static type set1(double v)            noexcept {return _mm256_set1_pd(v);}
+        static type add(type a, type b)       noexcept {return _mm256_add_pd(a, b);}
+        static type sub(type a, type b)       noexcept {return _mm256_sub_pd(a, b);}
+        static type mul(type a, type b)       noexcept {return _mm256_mul_pd(a, b);}
+        static type div(type a, type b)       noexcept {return _mm256_div_pd(a, b);}
+        static type sqrt(type a)              noexcept {return _mm256_sqrt_pd(a);}
+    };
+#elif defined(MTLKIT_SIMD_SSE2)
+    template<>
+    struct wide<float>
+    {
+        typedef __m128 type;
+        static const std::size_t WIDTH = 4;
+        static type load(const float* p)      noexcept {return _mm_loadu_ps(p);}
+        static void store(float* p, type v)   noexcept {_mm_storeu_ps(p, v);}
+        static type loada(const float* p)     noexcept {return _mm_load_ps(p);}
+        static void storea(float* p, type v)  noexcept {_mm_store_ps(p, v);}
+        static type set1(float v)             noexcept {return _mm_set1_ps(v);}
+        static type add(type a, type b)       noexcept {return _mm_add_ps(a, b);}
+        static type sub(type a, type b)       noexcept {return _mm_sub_ps(a, b);}
+        static type mul(type a, type b)       noexcept {return _mm_mul_ps(a, b);}
+        static type div(type a, type b)       noexcept {return _mm_div_ps(a, b);}
+        static type sqrt(type a)              noexcept {return _mm_sqrt_ps(a);}
+    };
+    template<>
+    struct wide<double>
+    {
+        typedef __m128d type;
+        static const std::size_t WIDTH = 2;
+        static type load(const double* p)     noexcept {return _mm_loadu_pd(p);}
+        static void store(double* p, type v)  noexcept {_mm_storeu_pd(p, v);}
+        static type loada(const double* p)    noexcept {return _mm_load_pd(p);}
+        static void storea(double* p, type v) noexcept {_mm_store_pd(p, v);}
+        static type set1(double v)            noexcept {return _mm_set1_pd(v);}
+        static type add(type a, type b)       noexcept {return _mm_add_pd(a, b);}
+        static type sub(type a, type b)       noexcept {return _mm_sub_pd(a, b);}
+        static type mul(type a, type b)       noexcept {return _mm_mul_pd(a, b);}
+        static type div(type a, type b)       noexcept {return _mm_div_pd(a, b);}
+        static type sqrt(type a)              noexcept {return _mm_sqrt_pd(a);}
+    };
+#endif
+    /*
+     * Runs the Kernel over count elements : two wide registers per iteration, then the scalar tail.
+     * A Kernel must provide value_type and template<typename Pack> void step(std::size_t i).
+     */
+    template<typename Kernel>
+    void run(std::size_t count, Kernel& kernel) noexcept
+    {
+        typedef wide<typename Kernel::value_type>   W;
+        typedef scalar<typename Kernel::value_type> S;
+        std::size_t i = 0;
+        for(;i+2*W::WIDTH<=count;i+=2*W::WIDTH)
+        {
+            kernel.template step<W>(i);
+            kernel.template step<W>(i + W::WIDTH);
+        }
+        for(;i<count;++i)
+        {
+            kernel.template step<S>(i);
+        }
+    }
+    // Defined with the expression templates, after VecStream.
+    template<typename Op, typename L, typename R> struct binary;
+    template<typename T, uint32_t N, typename E>  struct assign_kernel;
+}
+//! @endcond
+
+
+/**
+ * @class VecStream
+ * @brief A structure of arrays of \b count Vecf<T, N>, one contiguous lane per component.
+ *
+ * Usage :
+ * @code
+ * std::vector<Normal> normals = loadNormals();
+ * Vec3Stream stream(normals.data(), normals.size()); // x[], y[], z[]
+ * normalize(stream, stream);
+ * stream.interleave(mappedBuffer);                     // back to Normal[] for the upload.
+ * @endcode
+ *
+ * Arithmetic between streams, scalars and Vecf is lazy : it builds an expression which is
+ * evaluated in a single pass when assigned to a stream, without any intermediate stream.
+ * @code
+ * Vec3Stream a(n), b(n), c(n), result;
+ * result = a*s + b - c/t;                // One loop over n, no temporary.
+ * result = result + vec3(0.0f, 1.0f, 0.0f); // A Vecf is broadcast to every element.
+ * @endcode
+ * An expression only refers to its streams : don't keep it (with auto) beyond their lifespan.
+ */
+template<typename T, uint32_t N>
+class VecStream final
+{
+    public:
+        typedef Vecf<T, N> value_type; //!< The interleaved type this stream stores.
+
+        /**
+         * @brief Construct a stream of \b count vectors, filled with T().
+         * @param[in] count The number of vectors.
+         */
+        explicit VecStream(std::size_t count = 0)
+        {
+            this->resize(count);
+        }
+        /**
+         * @brief Construct a stream by splitting \b count interleaved vectors.
+         * @param[in] values The first interleaved vector.
+         * @param[in] count  The number of vectors to read from \b values.
+         * @pre \b values must address at least \b count vectors.
+         */
+        VecStream(const Vecf<T, N>* values, std::size_t count) : VecStream(count)
+        {
+            this->deinterleave(values, count);
+        }
+        /**
+         * @brief Grants access to the number of vectors stored.
+         * @return This number.
+         */
+        inline std::size_t size(void) const noexcept
+        {
+            return this->_lanes[0].size();
+        }
+        /**
+         * @brief Changes the number of stored vectors, new ones are filled with T().
+         * @param[in] count The new number of vectors.
+         */
+        void resize(std::size_t count)
+        {
+            for(uint32_t c=0;c<N;++c)
+            {
+                this->_lanes[c].resize(count, T());
+            }
+        }
+        /**
+         * @brief Grants access to every values of the component \b c (0 for x, 1 for y...).
+         * @param[in] c The component index.
+         * @return The address of size() contiguous values, aligned on MTLKIT_SIMD_ALIGNMENT bytes.
+         * @pre \b c must be lower than N.
+         */
+        inline T* lane(uint32_t c) noexcept
+        {
+            return this->_lanes[c].data();
+        }
+        /**
+         * @brief Grants access to every values of the component \b c (0 for x, 1 for y...), for a const stream.
+         * @param[in] c The component index.
+         * @return The address of size() contiguous values, aligned on MTLKIT_SIMD_ALIGNMENT bytes.
+         * @pre \b c must be lower than N.
+         */
+        inline const T* lane(uint32_t c) const noexcept
+        {
+            return this->_lanes[c].data();
+        }
+        /**
+         * @brief Gathers the vector at \b index from every lanes.
+         * @param[in] index The position of the vector.
+         * @return This vector, as an interleaved Vecf.
+         * @pre \b index must be lower than size().
+         */
+        Vecf<T, N> get(std::size_t index) const noexcept
+        {
+            Vecf<T, N> result;
+            T* values = result;
+            for(uint32_t c=0;c<N;++c)
+            {
+                values[c] = this->_lanes[c][index];
+            }
+            return result;
+        }
+        /**
+         * @brief Scatters \b value at \b index into every lanes.
+         * @param[in] index The position of the vector.
+         * @param[in] value The vector to store.
+         * @pre \b index must be lower than size().
+         */
+        void set(std::size_t index, const Vecf<T, N>& value) noexcept
+        {
+            const T* values = value;
+            for(uint32_t c=0;c<N;++c)
+            {
+                this->_lanes[c][index] = values[c];
+            }
+        }
+        /**
+         * @brief Writes the whole stream as size() interleaved Vecf into \b out.
+         * @details \b out can directly be a mapped buffer, so the upload costs this single pass.
+         * @param[out] out The first vector to write.
+         * @pre \b out must address at least size() vectors.
+         */
+        void interleave(Vecf<T, N>* out) const noexcept
+        {
+            T* dst = *out;
+            const std::size_t count = this->size();
+            for(std::size_t i=0;i<count;++i)
+            {
+                for(uint32_t c=0;c<N;++c)
+                {
+                    dst[i*N + c] = this->_lanes[c][i];
+                }
+            }
+        }
+        /**
+         * @brief Reads \b count interleaved Vecf from \b values into this stream.
+         * @param[in] values The first vector to read.
+         * @param[in] count  The number of vectors to read.
+         * @pre \b count must be lower or equal to size().
+         */
+        void deinterleave(const Vecf<T, N>* values, std::size_t count) noexcept
+        {
+            const T* src = *values;
+            for(std::size_t i=0;i<count;++i)
+            {
+                for(uint32_t c=0;c<N;++c)
+                {
+                    this->_lanes[c][i] = src[i*N + c];
+                }
+            }
+        }
+        /**
+         * @brief Evaluates \b expression in a single pass into this stream, resized if needed.
+         * @param[in] expression The lazy result of arithmetic operators on streams.
+         * @return A reference to this stream.
+         * @throw std::invalid_argument If the streams of \b expression don't have the same size.
+         */
+        template<typename Op, typename L, typename R>
+        VecStream<T, N>& operator=(const _vec_stream::binary<Op, L, R>& expression)
+        {
+            this->resize(expression.size());
+            _vec_stream::assign_kernel<T, N, _vec_stream::binary<Op, L, R> > kernel = {expression, *this};
+            _vec_stream::run(this->size(), kernel);
+            return *this;
+        }
+        /**
+         * @brief Construct a stream from the evaluation of \b expression.
+         * @param[in] expression The lazy result of arithmetic operators on streams.
+         * @throw std::invalid_argument If the streams of \b expression don't have the same size.
+         */
+        template<typename Op, typename L, typename R>
+        VecStream(const _vec_stream::binary<Op, L, R>& expression)
+        {
+            *this = expression;
+        }
+
+    private:
+        AlignedVector<T> _lanes[N]; //!< One array per component, aligned for the SIMD loads.
+
+        static_assert(sizeof(Vecf<T, N>) == N*sizeof(T), "Vecf must be tightly packed to be interleaved");
+};
+
+typedef VecStream<float, 3> Vec3Stream; //!< To manipulate a stream of vec3 (Vertex, Normal).
+typedef VecStream<float, 4> Vec4Stream; //!< To manipulate a stream of vec4 (Color).
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _vec_stream // The kernels, one step() per batch of Pack::WIDTH vectors.
+{
+    template<typename T, uint32_t N>
+    struct add_kernel
+    {
+        typedef T value_type;
+        const VecStream<T, N>& a;
+        const VecStream<T, N>& b;
+        VecStream<T, N>&       out;
+        template<typename P> void step(std::size_t i) noexcept
+        {
+            for(uint32_t c=0;c<N;++c)
+            {
+                P::storea(out.lane(c) + i, P::add(P::loada(a.lane(c) + i), P::loada(b.lane(c) + i)));
+            }
+        }
+    };
+    template<typename T, uint32_t N>
+    struct scale_kernel
+    {
+        typedef T value_type;
+        const VecStream<T, N>& a;
+        T                      f;
+        VecStream<T, N>&       out;
+        template<typename P> void step(std::size_t i) noexcept
+        {
+            const typename P::type factor = P::set1(f);
+            for(uint32_t c=0;c<N;++c)
+            {
+                P::storea(out.lane(c) + i, P::mul(P::loada(a.lane(c) + i), factor));
+            }
+        }
+    };
+    template<typename P, typename T, uint32_t N>
+    typename P::type dot(const VecStream<T, N>& a, const VecStream<T, N>& b, std::size_t i) noexcept
+    {
+        typename P::type sum = P::mul(P::loada(a.lane(0) + i), P::loada(b.lane(0) + i));
+        for(uint32_t c=1;c<N;++c)
+        {
+            sum = P::add(sum, P::mul(P::loada(a.lane(c) + i), P::loada(b.lane(c) + i)));
+        }
+        return sum;
+    }
+    template<typename T, uint32_t N>
+    struct dot_kernel
+    {
+        typedef T value_type;
+        const VecStream<T, N>& a;
+        const VecStream<T, N>& b;
+        T*                     out;
+        template<typename P> void step(std::size_t i) noexcept
+        {
+            P::store(out + i, dot<P>(a, b, i));
+        }
+    };
+    template<typename T>
+    struct cross_kernel
+    {
+        typedef T value_type;
+        const VecStream<T, 3>& a;
+        const VecStream<T, 3>& b;
+        VecStream<T, 3>&       out;
+        template<typename P> void step(std::size_t i) noexcept
+        {
+            typename P::type ax = P::loada(a.lane(0) + i), ay = P::loada(a.lane(1) + i), az = P::loada(a.lane(2) + i);
+            typename P::type bx = P::loada(b.lane(0) + i), by = P::loada(b.lane(1) + i), bz = P::loada(b.lane(2) + i);
+            P::storea(out.lane(0) + i, P::sub(P::mul(ay, bz), P::mul(az, by)));
+            P::storea(out.lane(1) + i, P::sub(P::mul(az, bx), P::mul(ax, bz)));
+            P::storea(out.lane(2) + i, P::sub(P::mul(ax, by), P::mul(ay, bx)));
+        }
+    };
+    template<typename T, uint32_t N>
+    struct normalize_kernel
+    {
+        typedef T value_type;
+        const VecStream<T, N>& a;
+        VecStream<T, N>&       out;
+        template<typename P> void step(std::size_t i) noexcept
+        {
+            const typename P::type length = P::sqrt(dot<P>(a, a, i));
+            for(uint32_t c=0;c<N;++c)
+            {
+                P::storea(out.lane(c) + i, P::div(P::loada(a.lane(c) + i), length));
+            }
+        }
+    };
+
+    template<typename T, uint32_t N>
+    void checkSizes(const VecStream<T, N>& a, std::size_t b)
+    {
+        if (a.size() != b)
+        {
+            throw std::invalid_argument("VecStream sizes mismatch !");
+        }
+    }
+}
+//! @endcond
+
+
+//! @cond SKIP_THIS_DOXYGEN
+namespace _vec_stream // The expression templates.
+{
+    /*
+     * Each node evaluates the component c of the elements [i, i + Pack::WIDTH[ with eval<Pack>(c, i).
+     * Scalars and Vecf have no size of their own, they match any stream.
+     */
+    const std::size_t UNBOUNDED = static_cast<std::size_t>(-1);
+
+    inline std::size_t mergeSizes(std::size_t a, std::size_t b)
+    {
+        if (a == UNBOUNDED || a == b)
+        {
+            return b;
+        }
+        if (b == UNBOUNDED)
+        {
+            return a;
+        }
+        throw std::invalid_argument("VecStream sizes mismatch !");
+    }
+
+    template<typename T, uint32_t N>
+    struct stream_leaf
+    {
+        typedef T scalar_type;
+        static const uint32_t SIZE = N;
+        const VecStream<T, N>& stream;
+        std::size_t size(void) const noexcept {return stream.size();}
+        template<typename P> typename P::type eval(uint32_t c, std::size_t i) const noexcept
+        {
+            return P::loada(stream.lane(c) + i);
+        }
+    };
+    template<typename T, uint32_t N>
+    struct scalar_leaf
+    {
+        typedef T scalar_type;
+        static const uint32_t SIZE = N;
+        T value;
+        std::size_t size(void) const noexcept {return UNBOUNDED;}
+        template<typename P> typename P::type eval(uint32_t, std::size_t) const noexcept
+        {
+            return P::set1(value);
+        }
+    };
+    template<typename T, uint32_t N>
+    struct vecf_leaf
+    {
+        typedef T scalar_type;
+        static const uint32_t SIZE = N;
+        Vecf<T, N> value;
+        std::size_t size(void) const noexcept {return UNBOUNDED;}
+        template<typename P> typename P::type eval(uint32_t c, std::size_t) const noexcept
+        {
+            return P::set1(static_cast<const T*>(value)[c]);
+        }
+    };
+
+    struct op_add {template<typename P> static typename P::type apply(typename P::type a, typename P::type b) noexcept {return P::add(a, b);}};
+    struct op_sub {template<typename P> static typename P::type apply(typename P::type a, typename P::type b) noexcept {return P::sub(a, b);}};
+    struct op_mul {template<typename P> static typename P::type apply(typename P::type a, typename P::type b) noexcept {return P::mul(a, b);}};
+    struct op_div {template<typename P> static typename P::type apply(typename P::type a, typename P::type b) noexcept {return P::div(a, b);}};
+
+    template<typename Op, typename L, typename R>
+    struct binary
+    {
+        typedef typename L::scalar_type scalar_type;
+        static const uint32_t SIZE = L::SIZE;
+        L left;
+        R right;
+        std::size_t size(void) const {return mergeSizes(left.size(), right.size());}
+        template<typename P> typename P::type eval(uint32_t c, std::size_t i) const noexcept
+        {
+            return Op::template apply<P>(left.template eval<P>(c, i), right.template eval<P>(c, i));
+        }
+    };
+
+    template<typename T, uint32_t N, typename E>
+    struct assign_kernel
+    {
+        typedef T value_type;
+        const E&         expression;
+        VecStream<T, N>& out;
+        template<typename P> void step(std::size_t i) noexcept
+        {
+            for(uint32_t c=0;c<N;++c)
+            {
+                P::storea(out.lane(c) + i, expression.template eval<P>(c, i));
+            }
+        }
+    };
+
+    /*
+     * What can start an expression : a stream, or an expression. It gives the T and N of the whole expression.
+     */
+    template<typename X> struct stream_like : public std::false_type {};
+    template<typename T, uint32_t N>
+    struct stream_like<VecStream<T, N> > : public std::true_type
+    {
+        typedef T scalar_type;
+        static const uint32_t SIZE = N;
+    };
+    template<typename Op, typename L, typename R>
+    struct stream_like<binary<Op, L, R> > : public std::true_type
+    {
+        typedef typename binary<Op, L, R>::scalar_type scalar_type;
+        static const uint32_t SIZE = binary<Op, L, R>::SIZE;
+    };
+
+    /*
+     * Turns an operand into a node of an expression of Vecf<T, N>.
+     */
+    template<typename X, typename T, uint32_t N>
+    struct operand
+    {
+        static_assert(std::is_arithmetic<X>::value, "VecStream operands must be streams, Vecf or numerics !");
+        typedef scalar_leaf<T, N> type;
+        static type wrap(const X& x) noexcept {type node = {static_cast<T>(x)}; return node;}
+    };
+    template<typename T, uint32_t N>
+    struct operand<VecStream<T, N>, T, N>
+    {
+        typedef stream_leaf<T, N> type;
+        static type wrap(const VecStream<T, N>& x) noexcept {type node = {x}; return node;}
+    };
+    template<typename T, uint32_t N>
+    struct operand<Vecf<T, N>, T, N>
+    {
+        typedef vecf_leaf<T, N> type;
+        static type wrap(const Vecf<T, N>& x) noexcept {type node = {x}; return node;}
+    };
+    template<typename Op, typename L, typename R, typename T, uint32_t N>
+    struct operand<binary<Op, L, R>, T, N>
+    {
+        static_assert(std::is_same<typename binary<Op, L, R>::scalar_type, T>::value && binary<Op, L, R>::SIZE == N,
+                      "Mixing VecStream of different types");
+        typedef binary<Op, L, R> type;
+        static const type& wrap(const type& x) noexcept {return x;}
+    };
+
+    template<typename Op, typename L, typename R>
+    struct make
+    {
+        typedef typename std::conditional<stream_like<L>::value, stream_like<L>, stream_like<R> >::type context;
+        typedef operand<L, typename context::scalar_type, context::SIZE> left;
+        typedef operand<R, typename context::scalar_type, context::SIZE> right;
+        typedef binary<Op, typename left::type, typename right::type> type;
+        static type build(const L& l, const R& r)
+        {
+            type node = {left::wrap(l), right::wrap(r)};
+            return node;
+        }
+    };
+    /*
+     * The operators below only exist if at least one side is a stream or an expression.
+     */
+    template<typename Op, typename L, typename R>
+    struct enable : public std::enable_if<stream_like<L>::value || stream_like<R>::value, make<Op, L, R> > {};
+}
+//! @endcond
+
+
+/**
+ * @brief Lazy sum of two operands, at least one of them being a VecStream or an expression.
+ * @param[in] l The left  operand : VecStream, expression, Vecf or numeric.
+ * @param[in] r The right operand : VecStream, expression, Vecf or numeric.
+ * @return An expression evaluated when assigned to a VecStream.
+ */
+template<typename L, typename R>
+typename _vec_stream::enable<_vec_stream::op_add, L, R>::type::type operator+(const L& l, const R& r)
+{
+    return _vec_stream::make<_vec_stream::op_add, L, R>::build(l, r);
+}
+/**
+ * @brief Lazy difference of two operands, at least one of them being a VecStream or an expression.
+ * @param[in] l The left  operand : VecStream, expression, Vecf or numeric.
+ * @param[in] r The right operand : VecStream, expression, Vecf or numeric.
+ * @return An expression evaluated when assigned to a VecStream.
+ */
+template<typename L, typename R>
+typename _vec_stream::enable<_vec_stream::op_sub, L, R>::type::type operator-(const L& l, const R& r)
+{
+    return _vec_stream::make<_vec_stream::op_sub, L, R>::build(l, r);
+}
+/**
+ * @brief Lazy component-wise product of two operands, at least one of them being a VecStream or an expression.
+ * @param[in] l The left  operand : VecStream, expression, Vecf or numeric.
+ * @param[in] r The right operand : VecStream, expression, Vecf or numeric.
+ * @return An expression evaluated when assigned to a VecStream.
+ */
+template<typename L, typename R>
+typename _vec_stream::enable<_vec_stream::op_mul, L, R>::type::type operator*(const L& l, const R& r)
+{
+    return _vec_stream::make<_vec_stream::op_mul, L, R>::build(l, r);
+}
+/**
+ * @brief Lazy component-wise quotient of two operands, at least one of them being a VecStream or an expression.
+ * @param[in] l The left  operand : VecStream, expression, Vecf or numeric.
+ * @param[in] r The right operand : VecStream, expression, Vecf or numeric.
+ * @return An expression evaluated when assigned to a VecStream.
+ */
+template<typename L, typename R>
+typename _vec_stream::enable<_vec_stream::op_div, L, R>::type::type operator/(const L& l, const R& r)
+{
+    return _vec_stream::make<_vec_stream::op_div, L, R>::build(l, r);
+}
+
+
+/**
+ * @brief Computes \b out = \b a + \b b for every vectors.
+ * @param[in]  a   The first  stream to sum.
+ * @param[in]  b   The second stream to sum.
+ * @param[out] out The result, which can be \b a or \b b.
+ * @throw std::invalid_argument If the streams don't have the same size.
+ */
+template<typename T, uint32_t N>
+void add(const VecStream<T, N>& a, const VecStream<T, N>& b, VecStream<T, N>& out)
+{
+    _vec_stream::checkSizes(a, b.size());
+    _vec_stream::checkSizes(a, out.size());
+    _vec_stream::add_kernel<T, N> kernel = {a, b, out};
+    _vec_stream::run(a.size(), kernel);
+}
+/**
+ * @brief Computes \b out = \b a * \b f for every vectors.
+ * @param[in]  a   The stream to scale.
+ * @param[in]  f   The scale factor.
+ * @param[out] out The result, which can be \b a.
+ * @throw std::invalid_argument If the streams don't have the same size.
+ */
+template<typename T, uint32_t N>
+void scale(const VecStream<T, N>& a, T f, VecStream<T, N>& out)
+{
+    _vec_stream::checkSizes(a, out.size());
+    _vec_stream::scale_kernel<T, N> kernel = {a, f, out};
+    _vec_stream::run(a.size(), kernel);
+}
+/**
+ * @brief Computes the dot product of every pair of vectors from \b a and \b b.
+ * @param[in]  a   The first  stream.
+ * @param[in]  b   The second stream.
+ * @param[out] out The a.size() dot products.
+ * @pre \b out must address at least a.size() values.
+ * @throw std::invalid_argument If the streams don't have the same size.
+ */
+template<typename T, uint32_t N>
+void dot(const VecStream<T, N>& a, const VecStream<T, N>& b, T* out)
+{
+    _vec_stream::checkSizes(a, b.size());
+    _vec_stream::dot_kernel<T, N> kernel = {a, b, out};
+    _vec_stream::run(a.size(), kernel);
+}
+/**
+ * @brief Computes the cross product of every pair of vectors from \b a and \b b.
+ * @param[in]  a   The first  stream.
+ * @param[in]  b   The second stream.
+ * @param[out] out The result, which can be \b a or \b b.
+ * @throw std::invalid_argument If the streams don't have the same size.
+ */
+template<typename T>
+void cross(const VecStream<T, 3>& a, const VecStream<T, 3>& b, VecStream<T, 3>& out)
+{
+    _vec_stream::checkSizes(a, b.size());
+    _vec_stream::checkSizes(a, out.size());
+    _vec_stream::cross_kernel<T> kernel = {a, b, out};
+    _vec_stream::run(a.size(), kernel);
+}
+/**
+ * @brief Scales every vectors of \b a to a length of 1.
+ * @param[in]  a   The stream to normalize.
+ * @param[out] out The result, which can be \b a.
+ * @throw std::invalid_argument If the streams don't have the same size.
+ */
+template<typename T, uint32_t N>
+void normalize(const VecStream<T, N>& a, VecStream<T, N>& out)
+{
+    static_assert(std::is_floating_point<T>::value, "Only floating point streams can be normalized");
+    _vec_stream::checkSizes(a, out.size());
+    _vec_stream::normalize_kernel<T, N> kernel = {a, out};
+    _vec_stream::run(a.size(), kernel);
+}
+
+#endif
@@ -21,7 +21,18 @@ SOURCES += \
     libs/XmlLoader/XmlWriter.cpp \
     src/Events.cpp \
     src/Pipeline.cpp \
-    src/Pipeline_traits.cpp
+    src/Pipeline_traits.cpp \
+    src/ThreadPool.cpp \
+    src/batch.cpp \
+    src/quat.cpp \
+    src/transform.cpp \
+    src/TransformHierarchy.cpp \
+    src/bounds.cpp \
+    src/BVH.cpp \
+    src/ProgramCache.cpp \
+    src/ProgramQueue.cpp \
+    src/ShaderVariants.cpp \
+    src/BufferRing.cpp
 
 HEADERS += \
     include/GlContext.hpp \
@@ -38,10 +49,27 @@ HEADERS += \
     include/Pipeline_traits.hpp \
     include/vec.hpp \
     include/keymap.hpp \
-    include/mat.hpp
+    include/mat.hpp \
+    include/simd.hpp \
+    include/vecstream.hpp \
+    include/meta.hpp \
+    include/packed.hpp \
+    include/aligned.hpp \
+    include/ThreadPool.hpp \
+    include/batch.hpp \
+    include/quat.hpp \
+    include/transform.hpp \
+    include/TransformHierarchy.hpp \
+    include/bounds.hpp \
+    include/BVH.hpp \
+    include/ProgramCache.hpp \
+    include/ProgramQueue.hpp \
+    include/ShaderVariants.hpp \
+    include/BlockLayout.hpp \
+    include/BufferRing.hpp
 
 QMAKE_CXXFLAGS += -std=c++11 -Wall -Wextra 
-LIBS += -lGLEW -lSDL2 -lSDL2_image -lGL
+LIBS += -lGLEW -lSDL2 -lSDL2_image -lGL -lpthread
 
 DISTFILES += \
     src/shaders/blinn_phong.glsl \
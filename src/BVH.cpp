@@ -0,0 +1,618 @@
+#include <algorithm>
+#include <limits>
+
+#include "BVH.hpp"
+
+
+namespace
+{
+    const uint32_t    BINS      = 16;      // The candidate planes of a split are the 15 borders between bins.
+    const uint32_t    LEAF      = 4;       // Up to this number of triangles, a node is always a leaf.
+    const uint32_t    BIG_LEAF  = 16;      // Above this number of triangles, a node is always split if it can be.
+    const uint32_t    MAX_DEPTH = 60;      // Deeper nodes are leaves, so the traversal stacks have a fixed size.
+    const std::size_t SUBTREE   = 1 << 14; // Ranges up to this number of triangles are built whole by one thread.
+    const std::size_t BLOCKS    = 64;      // The parallel passes over a big range are split in this many blocks.
+    const std::size_t QUERIES   = 64;      // The batched box queries list their triangles aside by this many boxes.
+    const float       TRAVERSAL = 1.0f;    // The cost of visiting a node, relative to testing a triangle.
+
+    typedef BVH::Node Node;
+
+    /*
+     * The boxes of the build, as plain floats : the passes over the triangles merge millions of them,
+     * and the compiler keeps these ones in registers when a vec3 would go through the memory.
+     */
+    struct Box
+    {
+        float lower[3];
+        float upper[3];
+
+        static Box empty(void)
+        {
+            const float inf = std::numeric_limits<float>::infinity();
+            return Box{{inf, inf, inf}, {-inf, -inf, -inf}};
+        }
+        void grow(const Box& box)
+        {
+            for(uint32_t k=0;k<3;++k)
+            {
+                this->lower[k] = std::min(this->lower[k], box.lower[k]);
+                this->upper[k] = std::max(this->upper[k], box.upper[k]);
+            }
+        }
+        void grow(const float* point)
+        {
+            for(uint32_t k=0;k<3;++k)
+            {
+                this->lower[k] = std::min(this->lower[k], point[k]);
+                this->upper[k] = std::max(this->upper[k], point[k]);
+            }
+        }
+        // Twice the centroid, on one axis : the binning only needs the order.
+        float center(uint32_t axis) const
+        {
+            return this->lower[axis] + this->upper[axis];
+        }
+        float area(void) const
+        {
+            const float x = this->upper[0] - this->lower[0];
+            const float y = this->upper[1] - this->lower[1];
+            const float z = this->upper[2] - this->lower[2];
+            return 2.0f * (x*y + y*z + z*x);
+        }
+        AABB bounds(void) const
+        {
+            return AABB{vec3(this->lower[0], this->lower[1], this->lower[2]), vec3(this->upper[0], this->upper[1], this->upper[2])};
+        }
+    };
+
+    // A triangle during the build : its box and its index, partitioned in place so the passes read forward.
+    struct Primitive
+    {
+        Box      box;
+        uint32_t id;
+    };
+
+    // A range of primitives to split, its node being already allocated.
+    struct Task
+    {
+        uint32_t node;
+        uint32_t begin;
+        uint32_t end;
+        uint32_t depth;
+        Box      centers; // The bounds of the (doubled) centroids of the range.
+    };
+
+    // A bin gathers the boxes of the primitives whose centroid falls in it, and the bounds of these centroids.
+    struct Bin
+    {
+        Box      bounds;
+        Box      centers;
+        uint32_t count;
+    };
+
+    uint32_t binOf(float centroid, float lower, float scale)
+    {
+        return std::min(BINS - 1, static_cast<uint32_t>((centroid - lower) * scale));
+    }
+
+    // Splits [begin, end) in BLOCKS ranges, processed by block(first, last, b) across the pool.
+    template<typename Block>
+    void blocks(ThreadPool& pool, uint32_t begin, uint32_t end, Block block)
+    {
+        const uint32_t size = static_cast<uint32_t>((end - begin + BLOCKS - 1) / BLOCKS);
+        pool.parallelFor(BLOCKS, 1, [&](std::size_t first, std::size_t last)
+        {
+            for(std::size_t b=first;b<last;++b)
+            {
+                const uint32_t from = std::min(end, static_cast<uint32_t>(begin + b*size));
+                block(from, std::min(end, from + size), b);
+            }
+        });
+    }
+
+    /*
+     * The binned SAH builder : a node is split along the widest axis of its centroids, at the border
+     * between BINS bins minimizing area(left) * count(left) + area(right) * count(right).
+     * The bins also bound their centroids, so the children get theirs without another pass.
+     */
+    struct Builder
+    {
+        std::vector<Primitive>& primitives;
+        std::vector<Primitive>& scratch; // The parallel partitions scatter there, then copy back.
+        ThreadPool&             pool;
+
+        // With partial, the blocks are binned in parallel and their own bins kept there.
+        void binning(uint32_t begin, uint32_t end, uint32_t axis, float lower, float scale, Bin* bins, Bin (*partial)[BINS]) const
+        {
+            for(uint32_t k=0;k<BINS;++k)
+            {
+                bins[k] = Bin{Box::empty(), Box::empty(), 0};
+            }
+            if (partial == nullptr)
+            {
+                for(uint32_t i=begin;i<end;++i)
+                {
+                    const Box& box = this->primitives[i].box;
+                    const float center[3] = {box.center(0), box.center(1), box.center(2)};
+                    Bin& bin = bins[binOf(center[axis], lower, scale)];
+                    bin.bounds.grow(box);
+                    bin.centers.grow(center);
+                    ++bin.count;
+                }
+                return;
+            }
+            blocks(this->pool, begin, end, [&](uint32_t from, uint32_t to, std::size_t b)
+            {
+                this->binning(from, to, axis, lower, scale, partial[b], nullptr);
+            });
+            for(std::size_t b=0;b<BLOCKS;++b)
+            {
+                const Bin* block = partial[b];
+                for(uint32_t k=0;k<BINS;++k)
+                {
+                    bins[k].bounds.grow(block[k].bounds);
+                    bins[k].centers.grow(block[k].centers);
+                    bins[k].count  += block[k].count;
+                }
+            }
+        }
+
+        // Partitions the range of task into the tasks left and right, false if it's better as a leaf.
+        bool split(const Task& task, float area, bool parallel, Task& left, Task& right, Box& leftBox, Box& rightBox) const
+        {
+            const uint32_t count = task.end - task.begin;
+            if (count <= LEAF || task.depth >= MAX_DEPTH)
+            {
+                return false;
+            }
+            float extent[3];
+            for(uint32_t k=0;k<3;++k)
+            {
+                extent[k] = task.centers.upper[k] - task.centers.lower[k];
+            }
+            uint32_t axis = (extent[1] > extent[0]) ? 1 : 0;
+            axis = (extent[2] > extent[axis]) ? 2 : axis;
+            if (!(extent[axis] > 0.0f))
+            {
+                return false;
+            }
+            const float lower = task.centers.lower[axis];
+            const float scale = BINS / extent[axis];
+            Bin bins[BINS];
+            Bin partial[BLOCKS][BINS];
+            parallel = parallel && count > SUBTREE;
+            this->binning(task.begin, task.end, axis, lower, scale, bins, parallel ? partial : nullptr);
+            // The right side of each border, then the left one while looking for the best border.
+            float    rightArea[BINS];
+            uint32_t rightCount[BINS];
+            Box      side   = Box::empty();
+            uint32_t inside = 0;
+            for(uint32_t k=BINS-1;k>0;--k)
+            {
+                side.grow(bins[k].bounds);
+                inside += bins[k].count;
+                rightArea[k]  = side.area();
+                rightCount[k] = inside;
+            }
+            float    best   = std::numeric_limits<float>::infinity();
+            uint32_t border = 0;
+            side   = Box::empty();
+            inside = 0;
+            for(uint32_t k=1;k<BINS;++k)
+            {
+                side.grow(bins[k - 1].bounds);
+                inside += bins[k - 1].count;
+                if (inside > 0 && rightCount[k] > 0)
+                {
+                    const float cost = side.area()*inside + rightArea[k]*rightCount[k];
+                    if (cost < best)
+                    {
+                        best   = cost;
+                        border = k;
+                    }
+                }
+            }
+            if (border == 0 || (count <= BIG_LEAF && TRAVERSAL + best / area >= count))
+            {
+                return false;
+            }
+            leftBox  = Box::empty();
+            rightBox = Box::empty();
+            left     = Task{0, task.begin, task.begin, task.depth + 1, Box::empty()};
+            right    = Task{0, task.begin, task.end,   task.depth + 1, Box::empty()};
+            for(uint32_t k=0;k<BINS;++k)
+            {
+                Box&  box  = (k < border) ? leftBox : rightBox;
+                Task& half = (k < border) ? left : right;
+                box.grow(bins[k].bounds);
+                half.centers.grow(bins[k].centers);
+                left.end += (k < border) ? bins[k].count : 0;
+            }
+            right.begin = left.end;
+            const auto isLeft = [&](const Primitive& primitive)
+            {
+                return binOf(primitive.box.center(axis), lower, scale) < border;
+            };
+            Primitive* first = this->primitives.data();
+            if (!parallel)
+            {
+                std::partition(first + task.begin, first + task.end, isLeft);
+                return true;
+            }
+            // The bins of each block count its primitives going left and right : their prefix sums are where it writes.
+            uint32_t leftAt[BLOCKS], rightAt[BLOCKS];
+            uint32_t leftEnd = left.begin, rightEnd = right.begin;
+            for(std::size_t b=0;b<BLOCKS;++b)
+            {
+                leftAt[b]  = leftEnd;
+                rightAt[b] = rightEnd;
+                for(uint32_t k=0;k<BINS;++k)
+                {
+                    ((k < border) ? leftEnd : rightEnd) += partial[b][k].count;
+                }
+            }
+            Primitive* other = this->scratch.data();
+            blocks(this->pool, task.begin, task.end, [&](uint32_t from, uint32_t to, std::size_t b)
+            {
+                for(uint32_t i=from;i<to;++i)
+                {
+                    other[isLeft(first[i]) ? leftAt[b]++ : rightAt[b]++] = first[i];
+                }
+            });
+            blocks(this->pool, task.begin, task.end, [&](uint32_t from, uint32_t to, std::size_t)
+            {
+                std::copy(other + from, other + to, first + from);
+            });
+            return true;
+        }
+
+        // Builds the task into nodes, depth first. With a pending list, the ranges up to limit go in it instead.
+        void run(std::vector<Node>& nodes, const Task& root, std::size_t limit, std::vector<Task>* pending) const
+        {
+            std::vector<Task> stack(1, root);
+            while(!stack.empty())
+            {
+                const Task task = stack.back();
+                stack.pop_back();
+                if (pending != nullptr && task.end - task.begin <= limit)
+                {
+                    pending->push_back(task);
+                    continue;
+                }
+                Task left, right;
+                Box  leftBox, rightBox;
+                const vec3  size = nodes[task.node].bounds.upper - nodes[task.node].bounds.lower;
+                const float area = 2.0f * (size[0]*size[1] + size[1]*size[2] + size[2]*size[0]);
+                if (!this->split(task, area, pending != nullptr, left, right, leftBox, rightBox))
+                {
+                    nodes[task.node].start = task.begin;
+                    nodes[task.node].count = task.end - task.begin;
+                    continue;
+                }
+                left.node  = static_cast<uint32_t>(nodes.size());
+                right.node = left.node + 1;
+                nodes[task.node].start = left.node;
+                nodes[task.node].count = 0;
+                nodes.push_back(Node{leftBox.bounds(), 0, 0});
+                nodes.push_back(Node{rightBox.bounds(), 0, 0});
+                stack.push_back(right);
+                stack.push_back(left);
+            }
+        }
+    };
+
+    // The parameter where the ray enters box, if it does before tMax.
+    bool slab(const AABB& box, const vec3& origin, const vec3& inverse, float tMax, float& tNear)
+    {
+        float t0 = 0.0f, t1 = tMax;
+        for(uint32_t k=0;k<3;++k)
+        {
+            float a = (box.lower[k] - origin[k]) * inverse[k];
+            float b = (box.upper[k] - origin[k]) * inverse[k];
+            if (a > b)
+            {
+                std::swap(a, b);
+            }
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, b);
+        }
+        tNear = t0;
+        return t0 <= t1;
+    }
+
+    // Moller-Trumbore : the hit is a + u(b - a) + v(c - a) = origin + t * direction.
+    bool hit(const vec3& a, const vec3& b, const vec3& c, const Ray& ray, float tMax, float& t, float& u, float& v)
+    {
+        const vec3  e1  = b - a;
+        const vec3  e2  = c - a;
+        const vec3  p   = cross(ray.direction, e2);
+        const float det = dot(e1, p);
+        if (det == 0.0f)
+        {
+            return false;
+        }
+        const float inverse = 1.0f / det;
+        const vec3  s = ray.origin - a;
+        u = dot(s, p) * inverse;
+        if (u < 0.0f || u > 1.0f)
+        {
+            return false;
+        }
+        const vec3 q = cross(s, e1);
+        v = dot(ray.direction, q) * inverse;
+        if (v < 0.0f || u + v > 1.0f)
+        {
+            return false;
+        }
+        t = dot(e2, q) * inverse;
+        return t >= 0.0f && t <= tMax;
+    }
+
+    // Visits the leaves hit by ray before tMax, nearest child first, until leaf returns true.
+    template<typename Leaf>
+    void traverse(const std::vector<Node>& nodes, const Ray& ray, const float& tMax, Leaf leaf)
+    {
+        const vec3 inverse(1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2]);
+        float near, far;
+        if (nodes.empty() || !slab(nodes[0].bounds, ray.origin, inverse, tMax, near))
+        {
+            return;
+        }
+        uint32_t stack[MAX_DEPTH + 2];
+        uint32_t size = 0;
+        stack[size++] = 0;
+        while(size > 0)
+        {
+            const Node& node = nodes[stack[--size]];
+            if (node.count > 0)
+            {
+                if (leaf(node))
+                {
+                    return;
+                }
+                continue;
+            }
+            const bool first  = slab(nodes[node.start].bounds,     ray.origin, inverse, tMax, near);
+            const bool second = slab(nodes[node.start + 1].bounds, ray.origin, inverse, tMax, far);
+            if (first && second)
+            {
+                const bool swap = far < near;
+                stack[size++] = node.start + (swap ? 0 : 1);
+                stack[size++] = node.start + (swap ? 1 : 0);
+            }
+            else if (first || second)
+            {
+                stack[size++] = node.start + (first ? 0 : 1);
+            }
+        }
+    }
+
+    bool overlaps(const AABB& a, const AABB& b)
+    {
+        for(uint32_t k=0;k<3;++k)
+        {
+            if (a.upper[k] < b.lower[k] || b.upper[k] < a.lower[k])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+
+const uint32_t BVH::NONE;
+
+BVH::BVH(const Vertex* vertices, const uint32_t* indices, std::size_t triangles, ThreadPool& pool)
+{
+    if (triangles == 0)
+    {
+        return;
+    }
+    const uint32_t count = static_cast<uint32_t>(triangles);
+    const auto corner = [&](uint32_t t, uint32_t k) -> const Vertex&
+    {
+        return vertices[(indices != nullptr) ? indices[3*t + k] : 3*t + k];
+    };
+    std::vector<Primitive> primitives(count), scratch;
+    Box bounds[BLOCKS], centers[BLOCKS];
+    blocks(pool, 0, count, [&](uint32_t from, uint32_t to, std::size_t b)
+    {
+        bounds[b]  = Box::empty();
+        centers[b] = Box::empty();
+        for(uint32_t t=from;t<to;++t)
+        {
+            Box box = Box::empty();
+            for(uint32_t k=0;k<3;++k)
+            {
+                box.grow(corner(t, k));
+            }
+            const float center[3] = {box.center(0), box.center(1), box.center(2)};
+            primitives[t] = Primitive{box, t};
+            bounds[b].grow(box);
+            centers[b].grow(center);
+        }
+    });
+    Task root{0, 0, count, 0, Box::empty()};
+    Box  box = Box::empty();
+    for(uint32_t b=0;b<BLOCKS;++b)
+    {
+        box.grow(bounds[b]);
+        root.centers.grow(centers[b]);
+    }
+    this->_nodes.reserve(2 * count / LEAF);
+    this->_nodes.push_back(Node{box.bounds(), 0, 0});
+    // The top of the tree is split with parallel passes, until there are enough subtrees for every thread.
+    const std::size_t limit = std::max<std::size_t>(SUBTREE, count / (8 * (pool.workers() + 1)));
+    if (count > limit)
+    {
+        scratch.resize(count);
+    }
+    const Builder builder{primitives, scratch, pool};
+    std::vector<Task> pending;
+    builder.run(this->_nodes, root, limit, &pending);
+    std::sort(pending.begin(), pending.end(), [](const Task& a, const Task& b)
+    {
+        return a.end - a.begin > b.end - b.begin;
+    });
+    std::vector<std::vector<Node>> subtrees(pending.size());
+    pool.parallelFor(pending.size(), 1, [&](std::size_t first, std::size_t last)
+    {
+        for(std::size_t i=first;i<last;++i)
+        {
+            Task task = pending[i];
+            subtrees[i].push_back(Node{this->_nodes[task.node].bounds, 0, 0});
+            task.node = 0;
+            builder.run(subtrees[i], task, 0, nullptr);
+        }
+    });
+    // Each subtree root replaces its pending node, the others are appended : the local child k lands at base + k - 1.
+    for(std::size_t i=0;i<pending.size();++i)
+    {
+        const uint32_t base = static_cast<uint32_t>(this->_nodes.size());
+        for(Node& node : subtrees[i])
+        {
+            if (node.count == 0)
+            {
+                node.start += base - 1;
+            }
+        }
+        this->_nodes[pending[i].node] = subtrees[i][0];
+        this->_nodes.insert(this->_nodes.end(), subtrees[i].begin() + 1, subtrees[i].end());
+    }
+    this->_triangles.resize(count);
+    this->_ids.resize(count);
+    pool.parallelFor(count, SUBTREE, [&](std::size_t first, std::size_t last)
+    {
+        for(std::size_t i=first;i<last;++i)
+        {
+            const uint32_t t = primitives[i].id;
+            this->_triangles[i] = Triangle{corner(t, 0), corner(t, 1), corner(t, 2)};
+            this->_ids[i]       = t;
+        }
+    });
+}
+
+RayHit BVH::intersect(const Ray& ray) const noexcept
+{
+    RayHit result{NONE, ray.tMax, 0.0f, 0.0f};
+    traverse(this->_nodes, ray, result.t, [&](const Node& node)
+    {
+        float t, u, v;
+        for(uint32_t i=node.start;i<node.start+node.count;++i)
+        {
+            const Triangle& triangle = this->_triangles[i];
+            if (hit(triangle.a, triangle.b, triangle.c, ray, result.t, t, u, v))
+            {
+                result = RayHit{this->_ids[i], t, u, v};
+            }
+        }
+        return false;
+    });
+    return result;
+}
+
+void BVH::intersect(const Ray* rays, RayHit* hits, std::size_t count, ThreadPool& pool) const
+{
+    pool.parallelFor(count, 256, [&](std::size_t first, std::size_t last)
+    {
+        for(std::size_t i=first;i<last;++i)
+        {
+            hits[i] = this->intersect(rays[i]);
+        }
+    });
+}
+
+bool BVH::occluded(const Ray& ray) const noexcept
+{
+    bool found = false;
+    traverse(this->_nodes, ray, ray.tMax, [&](const Node& node)
+    {
+        float t, u, v;
+        for(uint32_t i=node.start;i<node.start+node.count && !found;++i)
+        {
+            const Triangle& triangle = this->_triangles[i];
+            found = hit(triangle.a, triangle.b, triangle.c, ray, ray.tMax, t, u, v);
+        }
+        return found;
+    });
+    return found;
+}
+
+void BVH::query(const AABB& box, std::vector<uint32_t>& triangles) const
+{
+    if (this->_nodes.empty() || !overlaps(this->_nodes[0].bounds, box))
+    {
+        return;
+    }
+    uint32_t stack[MAX_DEPTH + 2];
+    uint32_t size = 0;
+    stack[size++] = 0;
+    while(size > 0)
+    {
+        const Node& node = this->_nodes[stack[--size]];
+        if (node.count > 0)
+        {
+            for(uint32_t i=node.start;i<node.start+node.count;++i)
+            {
+                const Triangle& t = this->_triangles[i];
+                if (overlaps(AABB{min(min(t.a, t.b), t.c), max(max(t.a, t.b), t.c)}, box))
+                {
+                    triangles.push_back(this->_ids[i]);
+                }
+            }
+            continue;
+        }
+        for(uint32_t child=node.start;child<node.start+2;++child)
+        {
+            if (overlaps(this->_nodes[child].bounds, box))
+            {
+                stack[size++] = child;
+            }
+        }
+    }
+}
+
+void BVH::query(const AABB* boxes, std::size_t count, std::vector<std::size_t>& offsets,
+                std::vector<uint32_t>& triangles, ThreadPool& pool) const
+{
+    // Each group of boxes fills its own list, the offsets being first relative to the group.
+    const std::size_t groups = (count + QUERIES - 1) / QUERIES;
+    std::vector<std::vector<uint32_t>> found(groups);
+    offsets.assign(count + 1, 0);
+    pool.parallelFor(groups, 1, [&](std::size_t first, std::size_t last)
+    {
+        for(std::size_t g=first;g<last;++g)
+        {
+            for(std::size_t i=g*QUERIES;i<std::min(count, (g + 1)*QUERIES);++i)
+            {
+                this->query(boxes[i], found[g]);
+                offsets[i + 1] = found[g].size();
+            }
+        }
+    });
+    std::vector<std::size_t> starts(groups);
+    std::size_t total = 0;
+    for(std::size_t g=0;g<groups;++g)
+    {
+        starts[g] = total;
+        total    += found[g].size();
+    }
+    triangles.resize(total);
+    pool.parallelFor(groups, 1, [&](std::size_t first, std::size_t last)
+    {
+        for(std::size_t g=first;g<last;++g)
+        {
+            for(std::size_t i=g*QUERIES;i<std::min(count, (g + 1)*QUERIES);++i)
+            {
+                offsets[i + 1] += starts[g];
+            }
+            std::copy(found[g].begin(), found[g].end(), triangles.begin() + starts[g]);
+        }
+    });
+}
+
+const std::vector<BVH::Node>& BVH::nodes(void) const noexcept
+{
+    return this->_nodes;
+}
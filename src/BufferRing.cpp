@@ -0,0 +1,174 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "BufferRing.hpp"
+
+
+namespace
+{
+    const GLuint64 WAIT_TIMEOUT = 1000000000; // A second, in nanoseconds, between two checks of a fence.
+
+    bool hasBufferStorage(void)
+    {
+        GLint major = 0;
+        GLint minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > 4 || (major == 4 && minor >= 4))
+        {
+            return true;
+        }
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for(GLint i=0;i<count;++i)
+        {
+            const GLubyte* extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+            if (extension != nullptr && std::strcmp(reinterpret_cast<const char*>(extension), "GL_ARB_buffer_storage") == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t offsetAlignment(GLenum target)
+    {
+        GLint alignment = 0;
+        if (target == GL_UNIFORM_BUFFER)
+        {
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        }
+#if defined(GL_SHADER_STORAGE_BUFFER)
+        else if (target == GL_SHADER_STORAGE_BUFFER)
+        {
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        }
+#endif
+        else
+        {
+            throw std::invalid_argument("BufferRing : the target must be GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER");
+        }
+        return (alignment > 0) ? static_cast<std::size_t>(alignment) : 256;
+    }
+}
+
+
+BufferRing::BufferRing(GLenum target, std::size_t frameSize, uint32_t frames)
+    : _target(target), _id(0), _alignment(offsetAlignment(target)), _frameSize(0), _frame(0), _head(0),
+      _memory(nullptr), _staging(), _fences(frames, nullptr), _persistent(false)
+{
+    if (frames == 0)
+    {
+        throw std::invalid_argument("BufferRing : there must be at least one frame");
+    }
+    this->_frameSize = (frameSize + this->_alignment - 1) / this->_alignment * this->_alignment;
+    this->_frame = frames - 1; // So the first beginFrame() starts with the first section.
+    const GLsizeiptr total = static_cast<GLsizeiptr>(this->_frameSize * frames);
+
+    glGenBuffers(1, &this->_id);
+    if (this->_id == 0)
+    {
+        throw std::runtime_error("Cannot create a buffer for OpenGL !");
+    }
+    glBindBuffer(target, this->_id);
+#if defined(GL_MAP_PERSISTENT_BIT)
+    if (hasBufferStorage())
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, total, nullptr, flags);
+        this->_memory = static_cast<unsigned char*>(glMapBufferRange(target, 0, total, flags));
+        if (this->_memory == nullptr)
+        {
+            glDeleteBuffers(1, &this->_id);
+            throw std::runtime_error("Cannot map the buffer of a BufferRing !");
+        }
+        this->_persistent = true;
+        return;
+    }
+#endif
+    glBufferData(target, total, nullptr, GL_DYNAMIC_DRAW);
+    this->_staging.resize(static_cast<std::size_t>(total));
+    this->_memory = this->_staging.data();
+}
+
+BufferRing::~BufferRing(void) noexcept
+{
+    for(GLsync fence : this->_fences)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+        }
+    }
+    if (this->_persistent)
+    {
+        glBindBuffer(this->_target, this->_id);
+        glUnmapBuffer(this->_target);
+    }
+    glDeleteBuffers(1, &this->_id);
+}
+
+void BufferRing::beginFrame(void)
+{
+    this->_frame = (this->_frame + 1) % static_cast<uint32_t>(this->_fences.size());
+    this->_head  = 0;
+    GLsync& fence = this->_fences[this->_frame];
+    if (fence == nullptr)
+    {
+        return;
+    }
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+    while (status == GL_TIMEOUT_EXPIRED)
+    {
+        status = glClientWaitSync(fence, 0, WAIT_TIMEOUT);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void BufferRing::endFrame(void)
+{
+    GLsync& fence = this->_fences[this->_frame];
+    if (fence != nullptr)
+    {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+BufferRing::Range BufferRing::allocate(std::size_t size)
+{
+    const std::size_t start = (this->_head + this->_alignment - 1) / this->_alignment * this->_alignment;
+    if (start + size > this->_frameSize)
+    {
+        throw std::length_error("BufferRing : no room left in this frame");
+    }
+    this->_head = start + size;
+    const std::size_t offset = this->_frame * this->_frameSize + start;
+    return Range{this->_memory + offset, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size)};
+}
+
+void BufferRing::bind(GLuint binding, const Range& range)
+{
+    if (!this->_persistent)
+    {
+        glBindBuffer(this->_target, this->_id);
+        glBufferSubData(this->_target, range.offset, range.size, range.data);
+    }
+    glBindBufferRange(this->_target, binding, this->_id, range.offset, range.size);
+}
+
+std::size_t BufferRing::used(void) const noexcept
+{
+    return this->_head;
+}
+
+bool BufferRing::persistent(void) const noexcept
+{
+    return this->_persistent;
+}
+
+BufferRing::operator GLuint(void) const noexcept
+{
+    return this->_id;
+}
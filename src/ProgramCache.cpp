@@ -0,0 +1,250 @@
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "ProgramCache.hpp"
+
+
+namespace
+{
+    const uint32_t MAGIC   = 0x504C544D; // "MTLP"
+    const uint32_t VERSION = 1;          // To bump when the header below changes.
+
+    // What is written before the binary itself.
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t size;
+    };
+
+    // FNV-1a, the length first so "ab" + "c" and "a" + "bc" differ.
+    void hash(uint64_t& h, const void* data, std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for(std::size_t i=0;i<size;++i)
+        {
+            h = (h ^ bytes[i]) * 0x100000001B3ull;
+        }
+    }
+
+    void hash(uint64_t& h, const std::string& value)
+    {
+        const uint64_t size = value.size();
+        hash(h, &size, sizeof(size));
+        hash(h, value.data(), value.size());
+    }
+
+    std::string driverString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return (value != nullptr) ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+    }
+
+    std::string path(const std::string& directory, uint64_t key)
+    {
+        char name[24];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return directory.empty() ? std::string(name) : directory + "/" + name;
+    }
+
+    GLuint compileShader(GLenum type, const std::string& source)
+    {
+        const GLuint shader = glCreateShader(type);
+        if (shader == 0)
+        {
+            throw std::runtime_error("Cannot create a shader for OpenGL !");
+        }
+        const GLchar* code = source.c_str();
+        glShaderSource(shader, 1, &code, nullptr);
+        glCompileShader(shader);
+        GLint status = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status == GL_FALSE)
+        {
+            GLint length = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+            std::string message(length > 0 ? length : 1, '\0');
+            glGetShaderInfoLog(shader, static_cast<GLsizei>(message.size()), nullptr, &message[0]);
+            glDeleteShader(shader);
+            throw std::runtime_error(message.c_str());
+        }
+        return shader;
+    }
+
+    // Deletes the shaders once linked, or when the compilation of another one throws.
+    struct Shaders
+    {
+        GLuint program;
+        std::vector<GLuint> ids;
+
+        ~Shaders(void) noexcept
+        {
+            for(GLuint id : ids)
+            {
+                glDetachShader(program, id);
+                glDeleteShader(id);
+            }
+        }
+    };
+
+    bool read(const std::string& file, uint64_t key, Header& header, std::vector<GLubyte>& data)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        {
+            return false;
+        }
+        if (header.magic != MAGIC || header.version != VERSION || header.key != key)
+        {
+            return false;
+        }
+        data.resize(header.size);
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(data.data()), header.size))
+            && stream.peek() == std::char_traits<char>::eof();
+    }
+
+    void write(const std::string& file, const Header& header, const std::vector<GLubyte>& data)
+    {
+        // Written aside then renamed, so a crash or a concurrent run never leaves half a binary.
+        const std::string temporary = file + ".tmp";
+        {
+            std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+            if (!stream)
+            {
+                stream.close();
+                std::remove(temporary.c_str());
+                return;
+            }
+        }
+        if (std::rename(temporary.c_str(), file.c_str()) != 0)
+        {
+            std::remove(file.c_str());
+            if (std::rename(temporary.c_str(), file.c_str()) != 0)
+            {
+                std::remove(temporary.c_str());
+            }
+        }
+    }
+}
+
+
+ProgramCache::ProgramCache(const std::string& directory) : _directory(directory), _stats{0, 0, 0}
+{
+
+}
+
+void ProgramCache::build(ShaderProgram& program, const std::vector<Stage>& stages, const std::vector<std::string>& defines)
+{
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    const bool supported = formats > 0;
+    const uint64_t programKey = supported ? key(stages, defines) : 0;
+    const std::string file = path(this->_directory, programKey);
+
+    if (supported)
+    {
+        Header header;
+        std::vector<GLubyte> data;
+        std::ifstream exists(file, std::ios::binary);
+        if (!exists)
+        {
+            ++this->_stats.misses;
+        }
+        else
+        {
+            exists.close();
+            if (read(file, programKey, header, data) && program.loadBinary(header.format, data))
+            {
+                ++this->_stats.hits;
+                return;
+            }
+            ++this->_stats.rejected;
+        }
+    }
+    else
+    {
+        ++this->_stats.misses;
+    }
+
+    link(program, stages, defines, supported);
+
+    if (supported)
+    {
+        GLenum format = 0;
+        const std::vector<GLubyte> data = program.binary(format);
+        if (!data.empty())
+        {
+            write(file, Header{MAGIC, VERSION, programKey, format, static_cast<uint32_t>(data.size())}, data);
+        }
+    }
+}
+
+void ProgramCache::link(ShaderProgram& program, const std::vector<Stage>& stages, const std::vector<std::string>& defines,
+                        bool retrievable)
+{
+    const GLuint id = static_cast<GLuint>(program);
+    Shaders shaders{id, {}};
+    for(const Stage& stage : stages)
+    {
+        shaders.ids.push_back(compileShader(stage.type, withDefines(stage.source, defines)));
+        glAttachShader(id, shaders.ids.back());
+    }
+    if (retrievable)
+    {
+        glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    program.link();
+}
+
+uint64_t ProgramCache::key(const std::vector<Stage>& stages, const std::vector<std::string>& defines)
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    hash(h, driverString(GL_VENDOR));
+    hash(h, driverString(GL_RENDERER));
+    hash(h, driverString(GL_VERSION));
+    for(const Stage& stage : stages)
+    {
+        const uint32_t type = stage.type;
+        hash(h, &type, sizeof(type));
+        hash(h, stage.source);
+    }
+    for(const std::string& define : defines)
+    {
+        hash(h, define);
+    }
+    return h;
+}
+
+std::string ProgramCache::withDefines(const std::string& source, const std::vector<std::string>& defines)
+{
+    if (defines.empty())
+    {
+        return source;
+    }
+    std::string lines;
+    for(const std::string& define : defines)
+    {
+        lines += "#define " + define + "\n";
+    }
+    const std::size_t version = source.find("#version");
+    if (version == std::string::npos)
+    {
+        return lines + source;
+    }
+    const std::size_t end = source.find('\n', version);
+    if (end == std::string::npos)
+    {
+        return source + "\n" + lines;
+    }
+    return source.substr(0, end + 1) + lines + source.substr(end + 1);
+}
+
+const ProgramCache::Stats& ProgramCache::stats(void) const noexcept
+{
+    return this->_stats;
+}
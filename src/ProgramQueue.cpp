@@ -0,0 +1,203 @@
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include "ProgramQueue.hpp"
+
+
+#ifndef GL_COMPLETION_STATUS_KHR
+    #define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+
+namespace
+{
+    bool hasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for(GLint i=0;i<count;++i)
+        {
+            const GLubyte* extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+            if (extension != nullptr && std::strcmp(reinterpret_cast<const char*>(extension), name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string shaderLog(GLuint shader)
+    {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::string message(length > 0 ? length : 1, '\0');
+        glGetShaderInfoLog(shader, static_cast<GLsizei>(message.size()), nullptr, &message[0]);
+        return message.c_str();
+    }
+
+    std::string programLog(GLuint program)
+    {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::string message(length > 0 ? length : 1, '\0');
+        glGetProgramInfoLog(program, static_cast<GLsizei>(message.size()), nullptr, &message[0]);
+        return message.c_str();
+    }
+}
+
+
+ProgramQueue::ProgramQueue(void) : _jobs(), _parallel(false)
+{
+    this->_parallel = hasExtension("GL_KHR_parallel_shader_compile") || hasExtension("GL_ARB_parallel_shader_compile");
+}
+
+ProgramQueue::~ProgramQueue(void) noexcept
+{
+    for(Job& job : this->_jobs)
+    {
+        for(GLuint shader : job.shaders)
+        {
+            glDetachShader(static_cast<GLuint>(*job.program), shader);
+            glDeleteShader(shader);
+        }
+    }
+}
+
+std::shared_future<void> ProgramQueue::submit(ShaderProgram& program, const std::vector<ProgramCache::Stage>& stages,
+                                              const std::vector<std::string>& defines, Ready ready)
+{
+    const GLuint id = static_cast<GLuint>(program);
+    Job job{&program, {}, std::promise<void>(), std::move(ready)};
+    for(const ProgramCache::Stage& stage : stages)
+    {
+        const GLuint shader = glCreateShader(stage.type);
+        if (shader == 0)
+        {
+            for(GLuint previous : job.shaders)
+            {
+                glDetachShader(id, previous);
+                glDeleteShader(previous);
+            }
+            throw std::runtime_error("Cannot create a shader for OpenGL !");
+        }
+        const std::string source = ProgramCache::withDefines(stage.source, defines);
+        const GLchar* code = source.c_str();
+        glShaderSource(shader, 1, &code, nullptr);
+        glCompileShader(shader);
+        glAttachShader(id, shader);
+        job.shaders.push_back(shader);
+    }
+    // Linked right away : the driver chains it after the compilations, nothing is queried until poll().
+    glLinkProgram(id);
+    std::shared_future<void> future = job.promise.get_future().share();
+    this->_jobs.push_back(std::move(job));
+    return future;
+}
+
+std::size_t ProgramQueue::poll(void)
+{
+    std::vector<bool> done(this->_jobs.size(), false);
+    if (!this->_parallel)
+    {
+        // Any status query waits for the driver, so one program per call keeps the frames coming.
+        if (!done.empty())
+        {
+            done[0] = true;
+        }
+    }
+    else
+    {
+        for(std::size_t i=0;i<this->_jobs.size();++i)
+        {
+            GLint completed = GL_FALSE;
+            glGetProgramiv(static_cast<GLuint>(*this->_jobs[i].program), GL_COMPLETION_STATUS_KHR, &completed);
+            done[i] = (completed == GL_TRUE);
+        }
+    }
+    return this->complete(done);
+}
+
+void ProgramQueue::finish(void)
+{
+    while (!this->_jobs.empty())
+    {
+        this->complete(std::vector<bool>(this->_jobs.size(), true));
+    }
+}
+
+std::size_t ProgramQueue::pending(void) const noexcept
+{
+    return this->_jobs.size();
+}
+
+bool ProgramQueue::parallel(void) const noexcept
+{
+    return this->_parallel;
+}
+
+std::size_t ProgramQueue::complete(const std::vector<bool>& done)
+{
+    // The finished jobs leave the queue before any callback, which may submit other programs.
+    std::vector<Job> finished;
+    std::vector<Job> remaining;
+    for(std::size_t i=0;i<this->_jobs.size();++i)
+    {
+        (done[i] ? finished : remaining).push_back(std::move(this->_jobs[i]));
+    }
+    this->_jobs = std::move(remaining);
+
+    std::vector<std::string> errors(finished.size());
+    for(std::size_t i=0;i<finished.size();++i)
+    {
+        Job& job = finished[i];
+        const GLuint id = static_cast<GLuint>(*job.program);
+        GLint linked = GL_FALSE;
+        glGetProgramiv(id, GL_LINK_STATUS, &linked);
+        if (linked != GL_TRUE)
+        {
+            // A shader which doesn't compile explains better than the link log.
+            for(GLuint shader : job.shaders)
+            {
+                GLint compiled = GL_FALSE;
+                glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+                if (compiled != GL_TRUE)
+                {
+                    errors[i] += shaderLog(shader);
+                }
+            }
+            if (errors[i].empty())
+            {
+                errors[i] = programLog(id);
+            }
+            if (errors[i].empty())
+            {
+                errors[i] = "Cannot link the program.";
+            }
+        }
+        for(GLuint shader : job.shaders)
+        {
+            glDetachShader(id, shader);
+            glDeleteShader(shader);
+        }
+        job.shaders.clear();
+        if (errors[i].empty())
+        {
+            job.program->reflect();
+            job.promise.set_value();
+        }
+        else
+        {
+            job.promise.set_exception(std::make_exception_ptr(std::runtime_error(errors[i])));
+        }
+    }
+    for(std::size_t i=0;i<finished.size();++i)
+    {
+        if (finished[i].ready)
+        {
+            finished[i].ready(*finished[i].program, errors[i]);
+        }
+    }
+    return finished.size();
+}
@@ -4,15 +4,107 @@
 #include <stdexcept>
 #include <memory>
 #include <algorithm>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 #include "GlCore.hpp"
 #include "ShaderProgram.hpp"
 
 
+namespace
+{
+    // Every uniform name interned so far, the deque keeping the references given by Uniform::name().
+    struct UniformNames
+    {
+        std::mutex                                mutex;
+        std::unordered_map<std::string, uint32_t> ids;
+        std::deque<std::string>                   names;
+    };
+
+    UniformNames& uniformNames(void)
+    {
+        static UniformNames table;
+        return table;
+    }
+
+    // Maps the id of uniform to slot, the ids added on the way being inactive.
+    void assign(std::vector<uint32_t>& slots, Uniform uniform, uint32_t slot)
+    {
+        if (uniform.id() >= slots.size())
+        {
+            slots.resize(uniform.id() + 1, Uniform::NONE);
+        }
+        slots[uniform.id()] = slot;
+    }
+
+    // GLEW declares the entry points of OpenGL 4.3 whatever the context is, they are null before it.
+    bool hasStorageBlocks(void)
+    {
+        GLint major = 0;
+        GLint minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > 4 || (major == 4 && minor >= 3))
+        {
+            return true;
+        }
+        bool interfaceQuery = false;
+        bool storageBuffer  = false;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for(GLint i=0;i<count;++i)
+        {
+            const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (extension != nullptr)
+            {
+                interfaceQuery = interfaceQuery || std::strcmp(extension, "GL_ARB_program_interface_query") == 0;
+                storageBuffer  = storageBuffer  || std::strcmp(extension, "GL_ARB_shader_storage_buffer_object") == 0;
+            }
+        }
+        return interfaceQuery && storageBuffer;
+    }
+}
+
+
+const uint32_t Uniform::NONE;
+
+Uniform::Uniform(const std::string& name) : _id(0)
+{
+    UniformNames& table = uniformNames();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    const auto found = table.ids.find(name);
+    if (found != table.ids.end())
+    {
+        this->_id = found->second;
+        return;
+    }
+    this->_id = static_cast<uint32_t>(table.names.size());
+    table.names.push_back(name);
+    table.ids.emplace(name, this->_id);
+}
+
+Uniform Uniform::find(const std::string& name)
+{
+    UniformNames& table = uniformNames();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    const auto found = table.ids.find(name);
+    return Uniform((found != table.ids.end()) ? found->second : NONE);
+}
+
+const std::string& Uniform::name(void) const
+{
+    UniformNames& table = uniformNames();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.names[this->_id];
+}
+
 
-ShaderProgram::ShaderProgram(void) : _id(0)
+
+ShaderProgram::ShaderProgram(void) : _id(0), _uniforms(), _slots()
 {
     this->_id = glCreateProgram();
     if (this->_id == 0)
@@ -32,7 +124,6 @@ ShaderProgram::ShaderProgram(const std::initializer_list<GLuint>& shadersId) : S
 ShaderProgram::~ShaderProgram(void) noexcept
 {
     glDeleteProgram(this->_id);
-    this->_locations.clear();
 }
 
 void ShaderProgram::link(void)
@@ -51,6 +142,85 @@ void ShaderProgram::link(void)
         message.release();
         throw std::runtime_error(fullMessage);
     }
+    this->reflect();
+}
+
+void ShaderProgram::reflect(void)
+{
+    this->_uniforms.clear();
+    this->_slots.clear();
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(this->_id, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string buffer(maxLength > 0 ? maxLength : 1, '\0');
+    for(GLint i=0;i<count;++i)
+    {
+        GLsizei length = 0;
+        GLint   size   = 0;
+        GLenum  type   = 0;
+        glGetActiveUniform(this->_id, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()), &length, &size, &type, &buffer[0]);
+        std::string name(buffer.data(), length);
+        const GLint location = glGetUniformLocation(this->_id, name.c_str());
+        if (location == -1)
+        {
+            continue; // A member of a uniform block, set through its buffer.
+        }
+        const uint32_t slot = static_cast<uint32_t>(this->_uniforms.size());
+        this->_uniforms.push_back(UniformSlot{location, 1, false, {}});
+        assign(this->_slots, Uniform(name), slot);
+        // An array is listed as "name[0]", its first element, which "name" also designates.
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+        {
+            name.resize(name.size() - 3);
+            assign(this->_slots, Uniform(name), slot);
+            this->_uniforms[slot].remaining = static_cast<uint32_t>(size > 1 ? size : 1);
+            for(GLint element=1;element<size;++element)
+            {
+                const std::string elementName = name + '[' + std::to_string(element) + ']';
+                assign(this->_slots, Uniform(elementName), static_cast<uint32_t>(this->_uniforms.size()));
+                this->_uniforms.push_back(UniformSlot{glGetUniformLocation(this->_id, elementName.c_str()),
+                                                      static_cast<uint32_t>(size - element), false, {}});
+            }
+        }
+    }
+}
+
+std::vector<GLubyte> ShaderProgram::binary(GLenum& format) const
+{
+    GLint length = 0;
+    glGetProgramiv(this->_id, GL_PROGRAM_BINARY_LENGTH, &length);
+    std::vector<GLubyte> result(length > 0 ? length : 0);
+    if (length > 0)
+    {
+        GLsizei written = 0;
+        glGetProgramBinary(this->_id, length, &written, &format, result.data());
+        result.resize(written);
+    }
+    return result;
+}
+
+bool ShaderProgram::loadBinary(GLenum format, const std::vector<GLubyte>& data) noexcept
+{
+    glProgramBinary(this->_id, format, data.data(), static_cast<GLsizei>(data.size()));
+    GLint status = GL_FALSE;
+    glGetProgramiv(this->_id, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE)
+    {
+        this->_uniforms.clear();
+        this->_slots.clear();
+        return false;
+    }
+    try
+    {
+        this->reflect();
+    }
+    catch (...)
+    {
+        this->_uniforms.clear();
+        this->_slots.clear();
+    }
+    return true;
 }
 
 void ShaderProgram::attach(GLuint shader)
@@ -111,19 +281,54 @@ bool ShaderProgram::isCurrentlyUsed(void) const noexcept
     return data;
 }
 
+GLint ShaderProgram::location(Uniform uniform) const noexcept
+{
+    const UniformSlot* slot = this->slot(uniform);
+    return (slot != nullptr) ? slot->location : -1;
+}
+
+bool ShaderProgram::bindUniformBlock(const std::string& blockName, GLuint binding) noexcept
+{
+    const GLuint index = glGetUniformBlockIndex(this->_id, blockName.c_str());
+    if (index == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+    glUniformBlockBinding(this->_id, index, binding);
+    return true;
+}
+
+bool ShaderProgram::bindStorageBlock(const std::string& blockName, GLuint binding) noexcept
+{
+#if defined(GL_SHADER_STORAGE_BLOCK)
+    if (!hasStorageBlocks())
+    {
+        return false;
+    }
+    const GLuint index = glGetProgramResourceIndex(this->_id, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+    if (index == GL_INVALID_INDEX)
+    {
+        return false;
+    }
+    glShaderStorageBlockBinding(this->_id, index, binding);
+    return true;
+#else
+    (void) blockName;
+    (void) binding;
+    return false;
+#endif
+}
+
 GLint ShaderProgram::uniformLocation(const std::string& uniformName) const noexcept
 {
-    std::map<std::string, GLint>::const_iterator iter = this->_locations.find(uniformName);
-    if (iter != this->_locations.end())
+    try
     {
-        return iter->second;
+        return this->location(Uniform::find(uniformName));
     }
-    GLint location = glGetUniformLocation(*this, uniformName.c_str());
-    if (location != -1)
+    catch (...)
     {
-        this->_locations.insert(std::make_pair(uniformName, location));
+        return glGetUniformLocation(*this, uniformName.c_str());
     }
-    return location;
 }
 
 GLuint ShaderProgram::id(void) const noexcept
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "ShaderVariants.hpp"
+
+
+ShaderVariants::ShaderVariants(const std::vector<ProgramCache::Stage>& stages, std::size_t capacity, ProgramCache* cache)
+    : _stages(stages), _capacity(capacity), _cache(cache), _variants(), _index(), _stats{0, 0, 0}
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("ShaderVariants : the capacity must be at least 1");
+    }
+}
+
+ShaderProgram& ShaderVariants::get(const std::vector<std::string>& defines)
+{
+    std::vector<std::string> sorted(defines);
+    const std::string key = normalize(sorted);
+    const auto found = this->_index.find(key);
+    if (found != this->_index.end())
+    {
+        ++this->_stats.hits;
+        this->_variants.splice(this->_variants.begin(), this->_variants, found->second);
+        return *found->second->program;
+    }
+
+    // Built before anything is evicted, so a variant which doesn't compile changes nothing.
+    std::unique_ptr<ShaderProgram> program(new ShaderProgram());
+    if (this->_cache != nullptr)
+    {
+        this->_cache->build(*program, this->_stages, sorted);
+    }
+    else
+    {
+        ProgramCache::link(*program, this->_stages, sorted);
+    }
+    ++this->_stats.compilations;
+
+    this->_variants.push_front(Variant{key, std::move(program)});
+    this->_index.emplace(key, this->_variants.begin());
+    while (this->_variants.size() > this->_capacity)
+    {
+        this->_index.erase(this->_variants.back().key);
+        this->_variants.pop_back();
+        ++this->_stats.evictions;
+    }
+    return *this->_variants.front().program;
+}
+
+bool ShaderVariants::contains(const std::vector<std::string>& defines) const
+{
+    std::vector<std::string> sorted(defines);
+    return this->_index.count(normalize(sorted)) > 0;
+}
+
+void ShaderVariants::clear(void) noexcept
+{
+    this->_index.clear();
+    this->_variants.clear();
+}
+
+std::size_t ShaderVariants::size(void) const noexcept
+{
+    return this->_variants.size();
+}
+
+std::size_t ShaderVariants::capacity(void) const noexcept
+{
+    return this->_capacity;
+}
+
+const ShaderVariants::Stats& ShaderVariants::stats(void) const noexcept
+{
+    return this->_stats;
+}
+
+std::string ShaderVariants::normalize(std::vector<std::string>& defines)
+{
+    std::sort(defines.begin(), defines.end());
+    defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+    std::string key;
+    for(const std::string& define : defines)
+    {
+        key += define;
+        key += '\n';
+    }
+    return key;
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "ThreadPool.hpp"
+
+
+namespace
+{
+    /*
+     * The state of one parallelFor, shared with its jobs : a job may only start once the loop is over
+     * (every range taken by the others), so this state can't live on the caller's stack.
+     */
+    struct ParallelLoop
+    {
+        ThreadPool::Range        task;
+        std::size_t              count;
+        std::size_t              chunk;
+        std::size_t              chunks;
+        std::atomic<std::size_t> next;
+        std::atomic<std::size_t> done;
+        std::mutex               mutex;
+        std::condition_variable  finished;
+        std::exception_ptr       error;
+    };
+
+    // Takes ranges until there is none left, the one finishing the last range wakes the caller up.
+    void runChunks(ParallelLoop& loop)
+    {
+        for(std::size_t c=loop.next++;c<loop.chunks;c=loop.next++)
+        {
+            const std::size_t begin = c*loop.chunk;
+            try
+            {
+                loop.task(begin, std::min(begin + loop.chunk, loop.count));
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(loop.mutex);
+                if (!loop.error)
+                {
+                    loop.error = std::current_exception();
+                }
+            }
+            if (++loop.done == loop.chunks)
+            {
+                std::lock_guard<std::mutex> lock(loop.mutex);
+                loop.finished.notify_all();
+            }
+        }
+    }
+}
+
+
+ThreadPool::ThreadPool(uint32_t workers) : _stop(false)
+{
+    for(uint32_t i=0;i<workers;++i)
+    {
+        this->_threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool(void) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_stop = true;
+    }
+    this->_wakeUp.notify_all();
+    for(std::thread& thread : this->_threads)
+    {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared(void)
+{
+    static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return pool;
+}
+
+uint32_t ThreadPool::workers(void) const noexcept
+{
+    return static_cast<uint32_t>(this->_threads.size());
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain, const Range& task)
+{
+    const std::size_t threads = this->_threads.size() + 1;
+    grain = std::max<std::size_t>(grain, 1);
+    if (threads == 1 || count <= grain)
+    {
+        if (count > 0)
+        {
+            task(0, count);
+        }
+        return;
+    }
+    // A few ranges per thread, so a slow thread doesn't hold the others back.
+    std::shared_ptr<ParallelLoop> loop = std::make_shared<ParallelLoop>();
+    loop->task   = task;
+    loop->count  = count;
+    loop->chunk  = std::max(grain, (count + 4*threads - 1) / (4*threads));
+    loop->chunks = (count + loop->chunk - 1) / loop->chunk;
+    loop->next   = 0;
+    loop->done   = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        for(std::size_t i=0,helpers=std::min(threads, loop->chunks)-1;i<helpers;++i)
+        {
+            this->_jobs.push_back([loop]() { runChunks(*loop); });
+        }
+    }
+    this->_wakeUp.notify_all();
+    runChunks(*loop);
+    {
+        std::unique_lock<std::mutex> lock(loop->mutex);
+        loop->finished.wait(lock, [&loop]() { return loop->done == loop->chunks; });
+    }
+    if (loop->error)
+    {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+void ThreadPool::work(void)
+{
+    for(;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_wakeUp.wait(lock, [this]() { return this->_stop || !this->_jobs.empty(); });
+            if (this->_jobs.empty())
+            {
+                return;
+            }
+            job = std::move(this->_jobs.front());
+            this->_jobs.pop_front();
+        }
+        job();
+    }
+}
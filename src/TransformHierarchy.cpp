@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#include "TransformHierarchy.hpp"
+
+
+namespace
+{
+    const std::size_t GRAIN = 1 << 12; // The smallest range of nodes given to a thread.
+}
+
+
+const TransformHierarchy::Node TransformHierarchy::NONE;
+
+TransformHierarchy::TransformHierarchy(void) noexcept
+{
+
+}
+
+TransformHierarchy::Node TransformHierarchy::add(const Transform3& local, Node parent)
+{
+    if (parent != NONE && parent >= this->_slots.size())
+    {
+        throw std::out_of_range("TransformHierarchy::add : unknown parent node");
+    }
+    const uint32_t depth = (parent == NONE) ? 0 : this->_slots[parent].level + 1;
+    if (depth == this->_levels.size())
+    {
+        this->_levels.emplace_back();
+        this->_levels.back().changed = 0;
+    }
+    Level& level = this->_levels[depth];
+    const Node node = static_cast<Node>(this->_slots.size());
+    level.parents.push_back((parent == NONE) ? NONE : this->_slots[parent].index);
+    level.nodes.push_back(node);
+    level.locals.push_back(local);
+    level.worlds.push_back(local);
+    level.dirty.push_back(1);
+    ++level.changed;
+    this->_slots.push_back(Slot{depth, static_cast<uint32_t>(level.locals.size() - 1)});
+    return node;
+}
+
+void TransformHierarchy::setLocal(Node node, const Transform3& local) noexcept
+{
+    const Slot slot = this->_slots[node];
+    Level& level = this->_levels[slot.level];
+    level.locals[slot.index] = local;
+    if (!level.dirty[slot.index])
+    {
+        level.dirty[slot.index] = 1;
+        ++level.changed;
+    }
+}
+
+const Transform3& TransformHierarchy::local(Node node) const noexcept
+{
+    const Slot slot = this->_slots[node];
+    return this->_levels[slot.level].locals[slot.index];
+}
+
+const Transform3& TransformHierarchy::world(Node node) const noexcept
+{
+    const Slot slot = this->_slots[node];
+    return this->_levels[slot.level].worlds[slot.index];
+}
+
+TransformHierarchy::Node TransformHierarchy::parent(Node node) const noexcept
+{
+    const Slot slot = this->_slots[node];
+    if (slot.level == 0)
+    {
+        return NONE;
+    }
+    return this->_levels[slot.level - 1].nodes[this->_levels[slot.level].parents[slot.index]];
+}
+
+std::size_t TransformHierarchy::size(void) const noexcept
+{
+    return this->_slots.size();
+}
+
+uint32_t TransformHierarchy::levels(void) const noexcept
+{
+    return static_cast<uint32_t>(this->_levels.size());
+}
+
+std::size_t TransformHierarchy::update(ThreadPool& pool)
+{
+    std::size_t total = 0;
+    for(std::size_t depth=0;depth<this->_levels.size();++depth)
+    {
+        Level& level = this->_levels[depth];
+        Level* above = (depth > 0) ? &this->_levels[depth - 1] : nullptr;
+        // Nothing moved here nor above : every world transform of this level is still valid.
+        if (level.changed == 0 && (above == nullptr || above->changed == 0))
+        {
+            continue;
+        }
+        std::atomic<std::size_t> recomputed(0);
+        pool.parallelFor(level.locals.size(), GRAIN, [&](std::size_t begin, std::size_t end)
+        {
+            std::size_t count = 0;
+            for(std::size_t i=begin;i<end;++i)
+            {
+                if (above == nullptr)
+                {
+                    if (level.dirty[i])
+                    {
+                        level.worlds[i] = level.locals[i];
+                        ++count;
+                    }
+                }
+                else if (level.dirty[i] || above->dirty[level.parents[i]])
+                {
+                    level.worlds[i] = above->worlds[level.parents[i]] * level.locals[i];
+                    level.dirty[i]  = 1;
+                    ++count;
+                }
+            }
+            recomputed += count;
+        });
+        level.changed = recomputed;
+        total += level.changed;
+        // The children of the level above are done, its flags can be cleared.
+        if (above != nullptr && above->changed > 0)
+        {
+            std::fill(above->dirty.begin(), above->dirty.end(), 0);
+            above->changed = 0;
+        }
+    }
+    if (!this->_levels.empty() && this->_levels.back().changed > 0)
+    {
+        std::fill(this->_levels.back().dirty.begin(), this->_levels.back().dirty.end(), 0);
+        this->_levels.back().changed = 0;
+    }
+    return total;
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+
+#include "batch.hpp"
+#include "simd.hpp"
+#include "ThreadPool.hpp"
+
+
+namespace
+{
+    const std::size_t GRAIN = 1 << 14; // The smallest range given to a thread, 256KB of vec4.
+
+    static_assert(sizeof(vec4) == 4*sizeof(float), "vec4 must be tightly packed to be batched");
+    static_assert(sizeof(vec3) == 3*sizeof(float), "vec3 must be tightly packed to be batched");
+
+    // Copies the 16 values of m column after column, so the kernels read each column as a register.
+    void columns(const mat4& m, float* out)
+    {
+        for(uint32_t c=0;c<4;++c)
+        {
+            for(uint32_t r=0;r<4;++r)
+            {
+                out[c*4 + r] = m(r, c);
+            }
+        }
+    }
+
+    // out = m * in, as a sum of the columns scaled by x, y, z and w.
+    void transform4(const float* m, const float* in, float* out, std::size_t count)
+    {
+        std::size_t i = 0;
+#if defined(MTLKIT_SIMD_AVX)
+        // Two vec4 per register, each column is repeated in both halves.
+        const __m256 w0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+        const __m256 w1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+        const __m256 w2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+        const __m256 w3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+        for(;i+2<=count;i+=2)
+        {
+            const __m256 v = _mm256_loadu_ps(in + 4*i);
+            __m256 r = _mm256_mul_ps(w0, _mm256_permute_ps(v, 0x00));
+            r = _mm256_add_ps(r, _mm256_mul_ps(w1, _mm256_permute_ps(v, 0x55)));
+            r = _mm256_add_ps(r, _mm256_mul_ps(w2, _mm256_permute_ps(v, 0xAA)));
+            r = _mm256_add_ps(r, _mm256_mul_ps(w3, _mm256_permute_ps(v, 0xFF)));
+            _mm256_storeu_ps(out + 4*i, r);
+        }
+#endif
+#if defined(MTLKIT_SIMD_SSE2)
+        const __m128 c0 = _mm_loadu_ps(m);
+        const __m128 c1 = _mm_loadu_ps(m + 4);
+        const __m128 c2 = _mm_loadu_ps(m + 8);
+        const __m128 c3 = _mm_loadu_ps(m + 12);
+        for(;i<count;++i)
+        {
+            const __m128 v = _mm_loadu_ps(in + 4*i);
+            __m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+            r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+            r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+            r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+            _mm_storeu_ps(out + 4*i, r);
+        }
+#endif
+        for(;i<count;++i)
+        {
+            const float* v = in + 4*i;
+            float r[4];
+            for(uint32_t row=0;row<4;++row)
+            {
+                r[row] = m[row]*v[0] + m[4 + row]*v[1] + m[8 + row]*v[2] + m[12 + row]*v[3];
+            }
+            std::copy(r, r + 4, out + 4*i);
+        }
+    }
+
+    // out = (m * vec4(in, 1)).xyz, the points are read and written as 3 floats.
+    void transform3(const float* m, const float* in, float* out, std::size_t count)
+    {
+        std::size_t i = 0;
+#if defined(MTLKIT_SIMD_SSE2)
+        const __m128 c0 = _mm_loadu_ps(m);
+        const __m128 c1 = _mm_loadu_ps(m + 4);
+        const __m128 c2 = _mm_loadu_ps(m + 8);
+        const __m128 c3 = _mm_loadu_ps(m + 12);
+        for(;i<count;++i)
+        {
+            const float* p = in + 3*i;
+            const __m128 x = _mm_set1_ps(p[0]);
+            const __m128 y = _mm_set1_ps(p[1]);
+            const __m128 z = _mm_set1_ps(p[2]);
+            const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)),
+                                        _mm_add_ps(_mm_mul_ps(c2, z), c3));
+            _mm_storel_pi(reinterpret_cast<__m64*>(out + 3*i), r);
+            _mm_store_ss(out + 3*i + 2, _mm_movehl_ps(r, r));
+        }
+#endif
+        for(;i<count;++i)
+        {
+            const float* p = in + 3*i;
+            float r[3];
+            for(uint32_t row=0;row<3;++row)
+            {
+                r[row] = m[row]*p[0] + m[4 + row]*p[1] + m[8 + row]*p[2] + m[12 + row];
+            }
+            std::copy(r, r + 3, out + 3*i);
+        }
+    }
+
+    // Runs kernel over the whole array, split across the shared pool when it is big enough.
+    template<uint32_t N>
+    void dispatch(const mat4& m, const Vecf<float, N>* in, Vecf<float, N>* out, std::size_t count,
+                  void (*kernel)(const float*, const float*, float*, std::size_t))
+    {
+        float values[16];
+        columns(m, values);
+        const float* src = reinterpret_cast<const float*>(in);
+        float*       dst = reinterpret_cast<float*>(out);
+        if (count < BATCH_PARALLEL_THRESHOLD)
+        {
+            kernel(values, src, dst, count);
+            return;
+        }
+        ThreadPool::shared().parallelFor(count, GRAIN, [&](std::size_t begin, std::size_t end)
+        {
+            kernel(values, src + N*begin, dst + N*begin, end - begin);
+        });
+    }
+}
+
+
+void transform(const mat4& m, const vec4* in, vec4* out, std::size_t count)
+{
+    dispatch(m, in, out, count, transform4);
+}
+
+void transform(const mat4& m, const vec3* in, vec3* out, std::size_t count)
+{
+    dispatch(m, in, out, count, transform3);
+}
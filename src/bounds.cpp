@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "batch.hpp"
+#include "bounds.hpp"
+#include "simd.hpp"
+#include "ThreadPool.hpp"
+
+
+namespace
+{
+    const std::size_t BLOCK = 8;       // The ranges start on a multiple of 8 boxes, so the lanes are aligned.
+    const std::size_t GRAIN = 1 << 11; // The smallest number of blocks given to a thread.
+
+    // A box is outside when it's behind a plane : dot(n, c) + d < -dot(|n|, e).
+    bool outside(const vec4& plane, float cx, float cy, float cz, float ex, float ey, float ez)
+    {
+        const float distance = plane[0]*cx + plane[1]*cy + plane[2]*cz + plane[3];
+        const float radius   = std::abs(plane[0])*ex + std::abs(plane[1])*ey + std::abs(plane[2])*ez;
+        return distance < -radius;
+    }
+
+    // Tests the boxes [begin, end), begin being a multiple of BLOCK, returns the number culled.
+    std::size_t cullRange(const vec4* planes, const BoxBatch& boxes, uint8_t* visible, std::size_t begin, std::size_t end)
+    {
+        const float* cx = boxes.lane(0);
+        const float* cy = boxes.lane(1);
+        const float* cz = boxes.lane(2);
+        const float* ex = boxes.lane(3);
+        const float* ey = boxes.lane(4);
+        const float* ez = boxes.lane(5);
+        std::size_t culled = 0;
+        std::size_t i = begin;
+#if defined(MTLKIT_SIMD_AVX)
+        for(;i+8<=end;i+=8)
+        {
+            const __m256 x = _mm256_load_ps(cx + i), y = _mm256_load_ps(cy + i), z = _mm256_load_ps(cz + i);
+            const __m256 w = _mm256_load_ps(ex + i), h = _mm256_load_ps(ey + i), d = _mm256_load_ps(ez + i);
+            __m256 out = _mm256_setzero_ps();
+            for(uint32_t p=0;p<6;++p)
+            {
+                const float* n = planes[p];
+                const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n[0]), x),
+                                                                    _mm256_mul_ps(_mm256_set1_ps(n[1]), y)),
+                                                      _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n[2]), z),
+                                                                    _mm256_set1_ps(n[3])));
+                const __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::abs(n[0])), w),
+                                                                  _mm256_mul_ps(_mm256_set1_ps(std::abs(n[1])), h)),
+                                                    _mm256_mul_ps(_mm256_set1_ps(std::abs(n[2])), d));
+                out = _mm256_or_ps(out, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+            const int mask = _mm256_movemask_ps(out);
+            for(uint32_t k=0;k<8;++k)
+            {
+                visible[i + k] = static_cast<uint8_t>(((mask >> k) & 1) ^ 1);
+                culled += (mask >> k) & 1;
+            }
+        }
+#endif
+#if defined(MTLKIT_SIMD_SSE2)
+        for(;i+4<=end;i+=4)
+        {
+            const __m128 x = _mm_load_ps(cx + i), y = _mm_load_ps(cy + i), z = _mm_load_ps(cz + i);
+            const __m128 w = _mm_load_ps(ex + i), h = _mm_load_ps(ey + i), d = _mm_load_ps(ez + i);
+            __m128 out = _mm_setzero_ps();
+            for(uint32_t p=0;p<6;++p)
+            {
+                const float* n = planes[p];
+                const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[0]), x),
+                                                              _mm_mul_ps(_mm_set1_ps(n[1]), y)),
+                                                   _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[2]), z), _mm_set1_ps(n[3])));
+                const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(n[0])), w),
+                                                            _mm_mul_ps(_mm_set1_ps(std::abs(n[1])), h)),
+                                                 _mm_mul_ps(_mm_set1_ps(std::abs(n[2])), d));
+                out = _mm_or_ps(out, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+            const int mask = _mm_movemask_ps(out);
+            for(uint32_t k=0;k<4;++k)
+            {
+                visible[i + k] = static_cast<uint8_t>(((mask >> k) & 1) ^ 1);
+                culled += (mask >> k) & 1;
+            }
+        }
+#endif
+        for(;i<end;++i)
+        {
+            bool hidden = false;
+            for(uint32_t p=0;p<6 && !hidden;++p)
+            {
+                hidden = outside(planes[p], cx[i], cy[i], cz[i], ex[i], ey[i], ez[i]);
+            }
+            visible[i] = hidden ? 0 : 1;
+            culled += hidden ? 1 : 0;
+        }
+        return culled;
+    }
+}
+
+
+AABB AABB::fromPoints(const vec3* points, std::size_t count) noexcept
+{
+    AABB box{points[0], points[0]};
+    for(std::size_t i=1;i<count;++i)
+    {
+        box.lower = min(box.lower, points[i]);
+        box.upper = max(box.upper, points[i]);
+    }
+    return box;
+}
+
+AABB transform(const Transform3& t, const AABB& box) noexcept
+{
+    // The new extents are the old ones through the absolute value of the linear part.
+    const vec3 center  = t.transformPoint(box.center());
+    const vec3 extents = box.extents();
+    const Transform3::Storage& m = t.matrix();
+    vec3 radius;
+    for(uint32_t r=0;r<3;++r)
+    {
+        radius[r] = std::abs(m(r, 0))*extents[0] + std::abs(m(r, 1))*extents[1] + std::abs(m(r, 2))*extents[2];
+    }
+    return AABB{center - radius, center + radius};
+}
+
+void BoxBatch::push(const AABB& box)
+{
+    const vec3 center  = box.center();
+    const vec3 extents = box.extents();
+    for(uint32_t i=0;i<3;++i)
+    {
+        this->_lanes[i].push_back(center[i]);
+        this->_lanes[3 + i].push_back(extents[i]);
+    }
+}
+
+void BoxBatch::clear(void) noexcept
+{
+    for(AlignedVector<float>& lane : this->_lanes)
+    {
+        lane.clear();
+    }
+}
+
+void BoxBatch::reserve(std::size_t count)
+{
+    for(AlignedVector<float>& lane : this->_lanes)
+    {
+        lane.reserve(count);
+    }
+}
+
+std::size_t BoxBatch::size(void) const noexcept
+{
+    return this->_lanes[0].size();
+}
+
+const float* BoxBatch::lane(uint32_t i) const noexcept
+{
+    return this->_lanes[i].data();
+}
+
+Frustum::Frustum(const mat4& viewProjection) noexcept
+{
+    // A point is inside when -w <= x, y, z <= w, so each plane is the last row plus or minus another one.
+    const vec4 rows[4] =
+    {
+        vec4(viewProjection(0, 0), viewProjection(0, 1), viewProjection(0, 2), viewProjection(0, 3)),
+        vec4(viewProjection(1, 0), viewProjection(1, 1), viewProjection(1, 2), viewProjection(1, 3)),
+        vec4(viewProjection(2, 0), viewProjection(2, 1), viewProjection(2, 2), viewProjection(2, 3)),
+        vec4(viewProjection(3, 0), viewProjection(3, 1), viewProjection(3, 2), viewProjection(3, 3))
+    };
+    for(uint32_t i=0;i<3;++i)
+    {
+        this->_planes[2*i]     = rows[3] + rows[i];
+        this->_planes[2*i + 1] = rows[3] - rows[i];
+    }
+    for(vec4& plane : this->_planes)
+    {
+        plane = plane / length(plane.xyz());
+    }
+}
+
+const vec4& Frustum::plane(uint32_t i) const noexcept
+{
+    return this->_planes[i];
+}
+
+bool Frustum::intersects(const AABB& box) const noexcept
+{
+    const vec3 c = box.center();
+    const vec3 e = box.extents();
+    for(const vec4& plane : this->_planes)
+    {
+        if (outside(plane, c[0], c[1], c[2], e[0], e[1], e[2]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersects(const Sphere& sphere) const noexcept
+{
+    for(const vec4& plane : this->_planes)
+    {
+        if (dot(plane.xyz(), sphere.center) + plane[3] < -sphere.radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+CullingStats cull(const Frustum& frustum, const BoxBatch& boxes, uint8_t* visible)
+{
+    vec4 planes[6];
+    for(uint32_t p=0;p<6;++p)
+    {
+        planes[p] = frustum.plane(p);
+    }
+    const std::size_t count = boxes.size();
+    CullingStats stats{count, 0};
+    if (count < BATCH_PARALLEL_THRESHOLD)
+    {
+        stats.culled = cullRange(planes, boxes, visible, 0, count);
+        return stats;
+    }
+    std::atomic<std::size_t> culled(0);
+    ThreadPool::shared().parallelFor((count + BLOCK - 1) / BLOCK, GRAIN, [&](std::size_t begin, std::size_t end)
+    {
+        culled += cullRange(planes, boxes, visible, begin*BLOCK, std::min(end*BLOCK, count));
+    });
+    stats.culled = culled;
+    return stats;
+}
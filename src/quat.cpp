@@ -0,0 +1,187 @@
+#include "quat.hpp"
+
+
+namespace
+{
+    // The 9 values of the rotation matrix of (x, y, z, w), row after row.
+    template<typename V>
+    void rotation(V x, V y, V z, V w, V* out)
+    {
+        const V two = V(2.0f), one = V(1.0f);
+        const V xx = x*x*two, yy = y*y*two, zz = z*z*two;
+        const V xy = x*y*two, xz = x*z*two, yz = y*z*two;
+        const V wx = w*x*two, wy = w*y*two, wz = w*z*two;
+        out[0] = one - (yy + zz); out[1] = xy - wz;         out[2] = xz + wy;
+        out[3] = xy + wz;         out[4] = one - (xx + zz); out[5] = yz - wx;
+        out[6] = xz - wy;         out[7] = yz + wx;         out[8] = one - (xx + yy);
+    }
+
+    // Writes the rotation r (row after row) into m, the rest of a mat4 being the identity.
+    template<uint32_t N>
+    void store(const float* r, Matrix<float, N, N>& m)
+    {
+        for(uint32_t row=0;row<N;++row)
+        {
+            for(uint32_t col=0;col<N;++col)
+            {
+                m(row, col) = (row < 3 && col < 3) ? r[row*3 + col] : ((row == col) ? 1.0f : 0.0f);
+            }
+        }
+    }
+
+#if defined(MTLKIT_SIMD_SSE2)
+    /*
+     * 4 quaternions in a structure of arrays, the SSE lanes are the quaternions.
+     */
+    struct Lanes
+    {
+        __m128 x, y, z, w;
+
+        explicit Lanes(const Quat* q)
+        {
+            const float* p = q->xyzw();
+            x = _mm_loadu_ps(p);
+            y = _mm_loadu_ps(p + 4);
+            z = _mm_loadu_ps(p + 8);
+            w = _mm_loadu_ps(p + 12);
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+        }
+        void store(Quat* q) const
+        {
+            __m128 a = x, b = y, c = z, d = w;
+            _MM_TRANSPOSE4_PS(a, b, c, d);
+            float* p = reinterpret_cast<float*>(q);
+            _mm_storeu_ps(p, a);
+            _mm_storeu_ps(p + 4, b);
+            _mm_storeu_ps(p + 8, c);
+            _mm_storeu_ps(p + 12, d);
+        }
+    };
+
+    // A float-like wrapper so rotation() runs on 4 quaternions at once.
+    struct Wide
+    {
+        __m128 v;
+
+        explicit Wide(__m128 value) : v(value) {}
+        explicit Wide(float value) : v(_mm_set1_ps(value)) {}
+        Wide() : v(_mm_setzero_ps()) {}
+        Wide operator*(Wide o) const {return Wide(_mm_mul_ps(v, o.v));}
+        Wide operator+(Wide o) const {return Wide(_mm_add_ps(v, o.v));}
+        Wide operator-(Wide o) const {return Wide(_mm_sub_ps(v, o.v));}
+    };
+
+    // _quat::slerpWeight on 4 lanes.
+    __m128 slerpWeight(__m128 t, __m128 cosAngle)
+    {
+        const __m128 squared = _mm_mul_ps(t, t);
+        const __m128 xm1     = _mm_sub_ps(cosAngle, _mm_set1_ps(1.0f));
+        __m128 weight = _mm_set1_ps(1.0f);
+        for(int i=7;i>=0;--i)
+        {
+            const __m128 b = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(_quat::SLERP_U[i]), squared),
+                                                   _mm_set1_ps(_quat::SLERP_V[i])), xm1);
+            weight = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(b, weight));
+        }
+        return _mm_mul_ps(t, weight);
+    }
+#endif
+
+    // toMatrices for mat3 and mat4, 4 quaternions per SSE iteration.
+    template<uint32_t N>
+    void convert(const Quat* q, Matrix<float, N, N>* out, std::size_t count)
+    {
+        std::size_t i = 0;
+#if defined(MTLKIT_SIMD_SSE2)
+        for(;i+4<=count;i+=4)
+        {
+            const Lanes lanes(q + i);
+            Wide values[9];
+            rotation(Wide(lanes.x), Wide(lanes.y), Wide(lanes.z), Wide(lanes.w), values);
+            float rows[9][4];
+            for(uint32_t v=0;v<9;++v)
+            {
+                _mm_storeu_ps(rows[v], values[v].v);
+            }
+            for(uint32_t k=0;k<4;++k)
+            {
+                float r[9];
+                for(uint32_t v=0;v<9;++v)
+                {
+                    r[v] = rows[v][k];
+                }
+                store(r, out[i + k]);
+            }
+        }
+#endif
+        for(;i<count;++i)
+        {
+            float r[9];
+            rotation(q[i].x(), q[i].y(), q[i].z(), q[i].w(), r);
+            store(r, out[i]);
+        }
+    }
+}
+
+
+mat3 toMat3(const Quat& q) noexcept
+{
+    mat3 result;
+    convert(&q, &result, 1);
+    return result;
+}
+
+mat4 toMat4(const Quat& q) noexcept
+{
+    mat4 result;
+    convert(&q, &result, 1);
+    return result;
+}
+
+void compose(const Quat* q1, const Quat* q2, Quat* out, std::size_t count) noexcept
+{
+    for(std::size_t i=0;i<count;++i)
+    {
+        out[i] = q1[i] * q2[i];
+    }
+}
+
+void slerp(const Quat* q1, const Quat* q2, const float* t, Quat* out, std::size_t count) noexcept
+{
+    std::size_t i = 0;
+#if defined(MTLKIT_SIMD_SSE2)
+    const __m128 SIGN = _mm_set1_ps(-0.0f);
+    for(;i+4<=count;i+=4)
+    {
+        const Lanes a(q1 + i), b(q2 + i);
+        const __m128 vt = _mm_loadu_ps(t + i);
+        __m128 cosAngle = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)),
+                                     _mm_add_ps(_mm_mul_ps(a.z, b.z), _mm_mul_ps(a.w, b.w)));
+        // The shortest path : a negative cosine flips q2, so its weight.
+        const __m128 side = _mm_and_ps(cosAngle, SIGN);
+        cosAngle = _mm_xor_ps(cosAngle, side);
+        const __m128 weight1 = slerpWeight(_mm_sub_ps(_mm_set1_ps(1.0f), vt), cosAngle);
+        const __m128 weight2 = _mm_xor_ps(slerpWeight(vt, cosAngle), side);
+        Lanes result = a;
+        result.x = _mm_add_ps(_mm_mul_ps(a.x, weight1), _mm_mul_ps(b.x, weight2));
+        result.y = _mm_add_ps(_mm_mul_ps(a.y, weight1), _mm_mul_ps(b.y, weight2));
+        result.z = _mm_add_ps(_mm_mul_ps(a.z, weight1), _mm_mul_ps(b.z, weight2));
+        result.w = _mm_add_ps(_mm_mul_ps(a.w, weight1), _mm_mul_ps(b.w, weight2));
+        result.store(out + i);
+    }
+#endif
+    for(;i<count;++i)
+    {
+        out[i] = slerp(q1[i], q2[i], t[i]);
+    }
+}
+
+void toMatrices(const Quat* q, mat3* out, std::size_t count) noexcept
+{
+    convert(q, out, count);
+}
+
+void toMatrices(const Quat* q, mat4* out, std::size_t count) noexcept
+{
+    convert(q, out, count);
+}
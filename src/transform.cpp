@@ -0,0 +1,157 @@
+#include <cmath>
+
+#include "transform.hpp"
+
+
+namespace
+{
+    // The transform whose linear part is the 3x3 matrix linear, followed by the translation offset.
+    template<typename L>
+    Transform3 affine(const Matrix<float, 3, 3, L>& linear, const vec3& offset)
+    {
+        Transform3::Storage rows;
+        for(uint32_t r=0;r<3;++r)
+        {
+            for(uint32_t c=0;c<3;++c)
+            {
+                rows(r, c) = linear(r, c);
+            }
+            rows(r, 3) = offset[r];
+        }
+        return Transform3(rows);
+    }
+}
+
+
+Transform3 Transform3::translation(const vec3& offset) noexcept
+{
+    Storage rows = Storage::identity();
+    for(uint32_t r=0;r<3;++r)
+    {
+        rows(r, 3) = offset[r];
+    }
+    return Transform3(rows);
+}
+
+Transform3 Transform3::rotation(const vec3& axis, float radians) noexcept
+{
+    return Transform3::rotation(Quat::fromAxisAngle(axis, radians));
+}
+
+Transform3 Transform3::rotation(const Quat& q) noexcept
+{
+    return affine(toMat3(q), vec3(0.0f, 0.0f, 0.0f));
+}
+
+Transform3 Transform3::scaling(const vec3& factors) noexcept
+{
+    Storage rows;
+    for(uint32_t r=0;r<3;++r)
+    {
+        rows(r, r) = factors[r];
+    }
+    return Transform3(rows);
+}
+
+Transform3 Transform3::lookAt(const vec3& eye, const vec3& target, const vec3& up) noexcept
+{
+    // The rows are the camera axes in the world : right, up, and backward since the camera looks down -z.
+    const vec3 forward = normalize(target - eye);
+    const vec3 right   = normalize(cross(forward, up));
+    const vec3 upward  = cross(right, forward);
+    Storage rows;
+    const vec3 axes[3] = {right, upward, forward * -1.0f};
+    for(uint32_t r=0;r<3;++r)
+    {
+        for(uint32_t c=0;c<3;++c)
+        {
+            rows(r, c) = axes[r][c];
+        }
+        rows(r, 3) = -dot(axes[r], eye);
+    }
+    return Transform3(rows);
+}
+
+Transform3 Transform3::ortho(float left, float right, float bottom, float top, float zNear, float zFar) noexcept
+{
+    Storage rows;
+    rows(0, 0) = 2.0f / (right - left);
+    rows(1, 1) = 2.0f / (top - bottom);
+    rows(2, 2) = -2.0f / (zFar - zNear);
+    rows(0, 3) = -(right + left) / (right - left);
+    rows(1, 3) = -(top + bottom) / (top - bottom);
+    rows(2, 3) = -(zFar + zNear) / (zFar - zNear);
+    return Transform3(rows);
+}
+
+Transform3 Transform3::translate(const vec3& offset) const noexcept
+{
+    return (*this) * Transform3::translation(offset);
+}
+
+Transform3 Transform3::rotate(const Quat& q) const noexcept
+{
+    return (*this) * Transform3::rotation(q);
+}
+
+Transform3 Transform3::scale(const vec3& factors) const noexcept
+{
+    return (*this) * Transform3::scaling(factors);
+}
+
+Transform3 Transform3::inverse(void) const
+{
+    // inverse(|L t|) = |inverse(L) -inverse(L)t|
+    //         |0 1|    |    0            1     |
+    Matrix<float, 3, 3, RowMajor> linear;
+    for(uint32_t r=0;r<3;++r)
+    {
+        for(uint32_t c=0;c<3;++c)
+        {
+            linear(r, c) = this->_matrix(r, c);
+        }
+    }
+    linear = linear.inverse();
+    const vec3 offset(this->_matrix(0, 3), this->_matrix(1, 3), this->_matrix(2, 3));
+    return affine(linear, (linear * offset) * -1.0f);
+}
+
+mat4 Transform3::toMat4(void) const noexcept
+{
+    mat4 result;
+    const float* rows = this->_matrix.data();
+#if defined(MTLKIT_SIMD_SSE2)
+    __m128 c0 = _mm_loadu_ps(rows);
+    __m128 c1 = _mm_loadu_ps(rows + 4);
+    __m128 c2 = _mm_loadu_ps(rows + 8);
+    __m128 c3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    float* columns = result.data();
+    _mm_storeu_ps(columns,      c0);
+    _mm_storeu_ps(columns + 4,  c1);
+    _mm_storeu_ps(columns + 8,  c2);
+    _mm_storeu_ps(columns + 12, c3);
+#else
+    for(uint32_t r=0;r<3;++r)
+    {
+        for(uint32_t c=0;c<4;++c)
+        {
+            result(r, c) = rows[4*r + c];
+        }
+    }
+    result(3, 3) = 1.0f;
+#endif
+    return result;
+}
+
+mat4 perspective(float fovy, float aspect, float zNear, float zFar) noexcept
+{
+    const float f = 1.0f / std::tan(fovy * 0.5f);
+    mat4 result;
+    result(0, 0) = f / aspect;
+    result(1, 1) = f;
+    result(2, 2) = (zFar + zNear) / (zNear - zFar);
+    result(2, 3) = 2.0f * zFar * zNear / (zNear - zFar);
+    result(3, 2) = -1.0f;
+    return result;
+}